@@ -0,0 +1,51 @@
+#include <activations/activations.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+using namespace NeuralNet;
+
+// Previous Relu kernel, evaluated through a function pointer by `unaryExpr`
+static Scalar reluValue(Scalar z) { return z < 0 ? 0 : z; }
+
+static Scalar reluDiffValue(Scalar a) { return a > 0 ? 1 : 0; }
+
+TEST_CASE("Activations throughput on 1M elements", "[benchmark]") {
+  const Matrix z = Matrix::Random(1000, 1000);
+  const Matrix grad = Matrix::Random(1000, 1000);
+  Matrix a(1000, 1000), delta(1000, 1000);
+
+  BENCHMARK("Relu (unaryExpr function pointer)") {
+    a = z.unaryExpr(&reluValue);
+    return a(0, 0);
+  };
+
+  BENCHMARK("Relu") {
+    Relu::activate(z, a);
+    return a(0, 0);
+  };
+
+  BENCHMARK("Sigmoid") {
+    Sigmoid::activate(z, a);
+    return a(0, 0);
+  };
+
+  BENCHMARK("Softmax") {
+    Softmax::activate(z, a);
+    return a(0, 0);
+  };
+
+  BENCHMARK("Relu backward (unaryExpr function pointer)") {
+    delta = grad.array() * z.unaryExpr(&reluDiffValue).array();
+    return delta(0, 0);
+  };
+
+  BENCHMARK("Relu backward") {
+    Relu::backward(z, grad, delta);
+    return delta(0, 0);
+  };
+
+  BENCHMARK("Sigmoid backward") {
+    Sigmoid::backward(z, grad, delta);
+    return delta(0, 0);
+  };
+}
@@ -0,0 +1,51 @@
+#include <Network.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+using namespace NeuralNet;
+
+TEST_CASE("Batching 16384 samples of 256 features", "[benchmark]") {
+  const int nSamples = 16384, nFeatures = 256, batchSize = 128;
+  std::vector<std::vector<double>> samples(nSamples,
+                                           std::vector<double>(nFeatures));
+  std::vector<double> labels(nSamples);
+
+  for (int i = 0; i < nSamples; i++) {
+    for (int f = 0; f < nFeatures; f++) samples[i][f] = ((i + f) % 256) / 255.0;
+    labels[i] = i % 10;
+  }
+
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(samples, labels);
+
+  BENCHMARK("batch") {
+    trainingData.batch(batchSize, false, false, false, false, false, 42);
+    return trainingData.getNumBatches();
+  };
+
+  BENCHMARK("batch (shuffled)") {
+    trainingData.batch(batchSize, false, true, false, false, false, 42);
+    return trainingData.getNumBatches();
+  };
+
+  BENCHMARK("batch (stratified, shuffled)") {
+    trainingData.batch(batchSize, true, true, false, false, false, 42);
+    return trainingData.getNumBatches();
+  };
+
+  trainingData.batch(batchSize, false, true, false, false, true, 42);
+
+  BENCHMARK("nextEpoch (reshuffled)") {
+    trainingData.nextEpoch();
+    return trainingData.getNumBatches();
+  };
+
+  Matrix x, y;
+
+  BENCHMARK("Gathering a batch") {
+    trainingData.gatherInputs(0, x);
+    trainingData.gatherLabels(0, y, 10);
+    return x(0, 0) + y(0, 0);
+  };
+}
@@ -0,0 +1,78 @@
+#include <Network.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NeuralNet;
+
+TEST_CASE("Dense layer forward and backward passes per layer size",
+          "[benchmark]") {
+  const int batchSize = 128;
+
+  for (int size : {64, 256, 1024}) {
+    // size inputs -> size neurons (Relu) -> 10 classes (fused softmax head)
+    std::vector<std::shared_ptr<Layer>> layers = {
+        std::make_shared<Dense>(size),
+        std::make_shared<Dense>(size, ACTIVATION::RELU, WEIGHT_INIT::HE),
+        std::make_shared<Dense>(10, ACTIVATION::SOFTMAX, WEIGHT_INIT::LECUN)};
+
+    Network network;
+    for (std::shared_ptr<Layer> &layer : layers) network.addLayer(layer);
+    network.setup(std::make_shared<SGD>(0.01), LOSS::MCE);
+
+    const Matrix x = Matrix::Random(batchSize, size);
+    std::vector<std::vector<double>> samples(batchSize,
+                                             std::vector<double>(size));
+    std::vector<double> labels(batchSize);
+    for (int i = 0; i < batchSize; i++) {
+      for (int j = 0; j < size; j++) samples[i][j] = x(i, j);
+      labels[i] = i % 10;
+    }
+
+    // A single batch, an epoch is a training step
+    TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+        trainingData(samples, labels);
+    trainingData.batch(batchSize);
+
+    const std::string name = std::to_string(size) + " neurons";
+
+    BENCHMARK("Dense forward (" + name + ")") {
+      return layers[1]->feedInputs(x)(0, 0);
+    };
+
+    BENCHMARK("Training step, forward + backward + SGD (" + name + ")") {
+      return network.train(trainingData, 1, {}, false);
+    };
+  }
+}
+
+TEST_CASE("Dense forward of a wide layer against the unfused computation",
+          "[benchmark]") {
+  const int batchSize = 128, size = 4096;
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(size);
+  std::shared_ptr<Layer> layer =
+      std::make_shared<Dense>(size, ACTIVATION::RELU, WEIGHT_INIT::HE);
+  Network network;
+  network.addLayer(inputLayer);
+  network.addLayer(layer);
+
+  const Matrix x = Matrix::Random(batchSize, size);
+  const Matrix weights = std::static_pointer_cast<Dense>(layer)->getWeights();
+  const Matrix biases = std::static_pointer_cast<Dense>(layer)->getBiases();
+  Matrix z(batchSize, size);
+
+  BENCHMARK("Dense forward (4096 neurons)") {
+    return layer->feedInputs(x)(0, 0);
+  };
+
+  // Plain GEMM, then the biases and the activation over the whole outputs
+  BENCHMARK("inputs * weights + biases, then Relu (4096 neurons)") {
+    z.noalias() = x * weights;
+    z.rowwise() += biases.row(0);
+    Relu::activate(z, z);
+    return z(0, 0);
+  };
+}
@@ -0,0 +1,46 @@
+#include <activations/activations.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <losses/losses.hpp>
+
+using namespace NeuralNet;
+
+TEST_CASE("Losses and their gradients on 1024 samples of 10 classes",
+          "[benchmark]") {
+  const int nSamples = 1024, nClasses = 10;
+  const Matrix logits = Matrix::Random(nSamples, nClasses) * 5;
+  const Matrix p = Softmax::activate(logits);
+  Matrix y = Matrix::Zero(nSamples, nClasses);
+  for (int i = 0; i < nSamples; i++) y(i, i % nClasses) = 1;
+
+  Matrix grad(nSamples, nClasses);
+
+  BENCHMARK("Quadratic") { return Quadratic::cmpLoss(p, y); };
+
+  BENCHMARK("Quadratic gradient") {
+    Quadratic::cmpLossGrad(p, y, grad);
+    return grad(0, 0);
+  };
+
+  BENCHMARK("MCE") { return MCE::cmpLoss(p, y); };
+
+  BENCHMARK("MCE gradient") {
+    MCE::cmpLossGrad(p, y, grad);
+    return grad(0, 0);
+  };
+
+  BENCHMARK("BCE") { return BCE::cmpLoss(p, y); };
+
+  BENCHMARK("BCE gradient") {
+    BCE::cmpLossGrad(p, y, grad);
+    return grad(0, 0);
+  };
+
+  // Fused softmax head, from the logits
+  BENCHMARK("SoftmaxMCE") { return SoftmaxMCE::cmpLoss(logits, y); };
+
+  BENCHMARK("SoftmaxMCE gradient") {
+    SoftmaxMCE::cmpLossGrad(p, y, grad);
+    return grad(0, 0);
+  };
+}
@@ -0,0 +1,46 @@
+#include <Network.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace NeuralNet;
+
+TEST_CASE("Saving and loading models", "[benchmark]") {
+  const std::string filename = "bench_model.bin";
+
+  // MNIST example's network (~100K parameters) and a wider one (~2M)
+  const std::vector<std::vector<int>> models = {{784, 128, 10},
+                                                {1024, 1024, 1024, 10}};
+
+  for (const std::vector<int> &sizes : models) {
+    Network network;
+    std::vector<std::shared_ptr<Layer>> layers = {
+        std::make_shared<Dense>(sizes[0])};
+    for (size_t l = 1; l < sizes.size(); l++) {
+      layers.push_back(
+          std::make_shared<Dense>(sizes[l], ACTIVATION::RELU, WEIGHT_INIT::HE));
+    }
+    for (std::shared_ptr<Layer> &layer : layers) network.addLayer(layer);
+    network.setup(std::make_shared<SGD>(0.01), LOSS::QUADRATIC);
+
+    std::string name;
+    for (size_t l = 0; l < sizes.size(); l++)
+      name += (l ? "-" : "") + std::to_string(sizes[l]);
+
+    BENCHMARK("Save (" + name + ")") {
+      network.to_file(filename);
+      return std::filesystem::file_size(filename);
+    };
+
+    BENCHMARK("Load (" + name + ")") {
+      Network loaded;
+      loaded.from_file(filename);
+      return loaded.getNumLayers();
+    };
+  }
+
+  std::filesystem::remove(filename);
+}
@@ -0,0 +1,166 @@
+#include <Network.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <memory>
+#include <optimizers/optimizers.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace NeuralNet;
+
+TEST_CASE("Optimizer steps on a 1000x1000 weights matrix", "[benchmark]") {
+  Matrix weights = Matrix::Random(1000, 1000);
+  const Matrix grad = Matrix::Random(1000, 1000) * 1e-3;
+
+  SGD sgd(0.01);
+
+  BENCHMARK("SGD") {
+    sgd.updateWeights(weights, grad);
+    return weights(0, 0);
+  };
+
+  SGD momentum(0.01, 0.9), nesterov(0.01, 0.9, true);
+  Matrix velocity = Matrix::Zero(1000, 1000);
+
+  BENCHMARK("SGD (momentum)") {
+    momentum.update(weights, grad, velocity);
+    return weights(0, 0);
+  };
+
+  BENCHMARK("SGD (Nesterov)") {
+    nesterov.update(weights, grad, velocity);
+    return weights(0, 0);
+  };
+
+  Adam adam(0.001);
+  Matrix m = Matrix::Zero(1000, 1000), v = Matrix::Zero(1000, 1000);
+
+  BENCHMARK("Adam") {
+    adam.update(weights, grad, m, v);
+    return weights(0, 0);
+  };
+}
+
+TEST_CASE("Adam steps on 10M parameters", "[benchmark]") {
+  const int rows = 10000, cols = 1000;
+  Matrix param = Matrix::Random(rows, cols);
+  const Matrix grad = Matrix::Random(rows, cols) * 1e-3;
+  Matrix m = Matrix::Zero(rows, cols), v = Matrix::Zero(rows, cols);
+
+  // Previous implementation, a pass per expression and std::pow every update
+  const double alpha = 0.001, beta1 = 0.9, beta2 = 0.999, epsilon = 10E-8;
+  int t = 0;
+
+  BENCHMARK("Adam (separate passes)") {
+    t++;
+    m = (beta1 * m).array() + ((1 - beta1) * grad.array()).array();
+    v = (beta2 * v).array() +
+        ((1 - beta2) * (grad.array() * grad.array())).array();
+    const double alphaT = alpha * (std::sqrt(1 - std::pow(beta2, t)) /
+                                   (1 - std::pow(beta1, t)));
+    param = param.array() - alphaT * (m.array() / (v.array().sqrt() + epsilon));
+    return param(0, 0);
+  };
+
+  Adam adam(alpha, beta1, beta2, epsilon);
+
+  BENCHMARK("Adam (fused)") {
+    adam.update(param, grad, m, v);
+    return param(0, 0);
+  };
+
+  AdamW adamW(alpha, beta1, beta2, epsilon);
+
+  BENCHMARK("AdamW (fused)") {
+    adamW.update(param, grad, m, v);
+    return param(0, 0);
+  };
+}
+
+TEST_CASE("Training steps of a 10M parameters model", "[benchmark]") {
+  // 784 -> 2048 -> 2048 -> 2048 -> 10 : 10.0M parameters
+  const int nInputs = 784, batchSize = 16;
+  std::vector<std::vector<double>> samples(batchSize,
+                                           std::vector<double>(nInputs));
+  std::vector<double> labels(batchSize);
+  for (int i = 0; i < batchSize; i++) {
+    for (int j = 0; j < nInputs; j++) samples[i][j] = (i + j) % 7 / 7.0;
+    labels[i] = i % 10;
+  }
+
+  // A single batch, an epoch is a training step
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(samples, labels);
+  trainingData.batch(batchSize);
+
+  const std::vector<std::pair<std::string, std::shared_ptr<Optimizer>>>
+      optimizers = {{"SGD", std::make_shared<SGD>(0.01)},
+                    {"Adam", std::make_shared<Adam>(0.001)},
+                    {"AdamW", std::make_shared<AdamW>(0.001)}};
+
+  for (const auto &[name, optimizer] : optimizers) {
+    std::vector<std::shared_ptr<Layer>> layers = {
+        std::make_shared<Dense>(nInputs),
+        std::make_shared<Dense>(2048, ACTIVATION::RELU, WEIGHT_INIT::HE),
+        std::make_shared<Dense>(2048, ACTIVATION::RELU, WEIGHT_INIT::HE),
+        std::make_shared<Dense>(2048, ACTIVATION::RELU, WEIGHT_INIT::HE),
+        std::make_shared<Dense>(10, ACTIVATION::SOFTMAX, WEIGHT_INIT::LECUN)};
+
+    Network network;
+    for (std::shared_ptr<Layer> &layer : layers) network.addLayer(layer);
+    network.setup(optimizer, LOSS::MCE);
+
+    BENCHMARK("Training step (" + name + ")") {
+      return network.train(trainingData, 1, {}, false);
+    };
+  }
+}
+
+TEST_CASE("Training steps per update schedule", "[benchmark]") {
+  const int nInputs = 32, batchSize = 16;
+  std::vector<std::vector<double>> samples(batchSize,
+                                           std::vector<double>(nInputs));
+  std::vector<double> labels(batchSize);
+  for (int i = 0; i < batchSize; i++) {
+    for (int j = 0; j < nInputs; j++) samples[i][j] = (i + j) % 7 / 7.0;
+    labels[i] = i % 10;
+  }
+
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(samples, labels);
+  trainingData.batch(batchSize);
+
+  // Deep and narrow (32 layers of 32 neurons) then shallow and wide
+  const std::vector<std::pair<std::string, std::vector<int>>> shapes = {
+      {"32x32", std::vector<int>(32, 32)}, {"2x2048", {2048, 2048}}};
+
+  for (const auto &[shape, sizes] : shapes) {
+    for (UPDATE_SCHEDULE schedule :
+         {UPDATE_SCHEDULE::PER_LAYER, UPDATE_SCHEDULE::AFTER_BACKPROP}) {
+      std::vector<std::shared_ptr<Layer>> layers = {
+          std::make_shared<Dense>(nInputs)};
+      for (int size : sizes) {
+        layers.push_back(
+            std::make_shared<Dense>(size, ACTIVATION::RELU, WEIGHT_INIT::HE));
+      }
+      layers.push_back(
+          std::make_shared<Dense>(10, ACTIVATION::SOFTMAX, WEIGHT_INIT::LECUN));
+
+      Network network;
+      for (std::shared_ptr<Layer> &layer : layers) network.addLayer(layer);
+      network.setup(std::make_shared<Adam>(0.001), LOSS::MCE);
+      network.setTrainingMode(TRAINING_MODE::SEQUENTIAL, 0);  // Every core
+      network.setUpdateSchedule(schedule);
+
+      const std::string name = schedule == UPDATE_SCHEDULE::PER_LAYER
+                                   ? "per layer"
+                                   : "after backprop";
+
+      BENCHMARK("Adam training step, " + shape + " (" + name + ")") {
+        return network.train(trainingData, 1, {}, false);
+      };
+    }
+  }
+}
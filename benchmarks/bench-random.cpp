@@ -0,0 +1,73 @@
+#include <Network.hpp>
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <iterator>
+#include <random>
+#include <tuple>
+#include <utils/Random.hpp>
+#include <vector>
+
+using namespace NeuralNet;
+
+TEST_CASE("Weights initialization of a 1000x1000 layer", "[benchmark]") {
+  Matrix weights(1000, 1000);
+
+  // Previous initialization, a new seeded engine for every weight
+  BENCHMARK("Uniform (engine per value)") {
+    for (Eigen::Index i = 0; i < weights.size(); i++) {
+      std::mt19937_64 rng(std::random_device{}());
+      weights.data()[i] = std::uniform_real_distribution<double>(-1, 1)(rng);
+    }
+    return weights(0, 0);
+  };
+
+  BENCHMARK("Normal (std::normal_distribution)") {
+    std::default_random_engine rng(std::random_device{}());
+    std::normal_distribution<double> distribution(0, 1);
+    for (Eigen::Index i = 0; i < weights.size(); i++) {
+      weights.data()[i] = distribution(rng);
+    }
+    return weights(0, 0);
+  };
+
+  Philox generator = randomGenerator();
+
+  BENCHMARK("Uniform (Philox)") {
+    fillUniform(weights, generator, -1, 1);
+    return weights(0, 0);
+  };
+
+  BENCHMARK("Normal (Philox)") {
+    fillNormal(weights, generator, 0, 1);
+    return weights(0, 0);
+  };
+}
+
+TEST_CASE("Dropout on a 256x4096 batch", "[benchmark]") {
+  const Matrix inputs = Matrix::Random(256, 4096);
+  Matrix outputs(256, 4096);
+
+  // Previous masks, exactly rate * n zeros sampled from all the coordinates
+  BENCHMARK("Sampled coordinates, double mask") {
+    std::vector<std::tuple<int, int>> coordinates, sampled;
+    for (int i = 0; i < inputs.rows(); i++) {
+      for (int j = 0; j < inputs.cols(); j++) coordinates.emplace_back(i, j);
+    }
+    std::mt19937 gen(42);
+    std::sample(coordinates.begin(), coordinates.end(),
+                std::back_inserter(sampled), inputs.size() / 2, gen);
+
+    Matrix mask = Matrix::Ones(inputs.rows(), inputs.cols());
+    for (const std::tuple<int, int> &c : sampled)
+      mask(std::get<0>(c), std::get<1>(c)) = 0;
+    outputs.array() = inputs.array() * mask.array() * 2;
+    return outputs(0, 0);
+  };
+
+  Dropout dropout(0.5, 42);
+
+  BENCHMARK("Bernoulli byte mask") {
+    return dropout.feedInputs(inputs)(0, 0);
+  };
+}
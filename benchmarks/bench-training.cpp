@@ -0,0 +1,132 @@
+#include <Network.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace NeuralNet;
+
+using Images = std::vector<std::vector<std::vector<double>>>;
+
+/**
+ * Builds the network of the MNIST example (examples/train-predict-MNIST)
+ */
+std::shared_ptr<Network> mnistNetwork() {
+  std::shared_ptr<Network> network = std::make_shared<Network>();
+
+  std::shared_ptr<Layer> flatten =
+      std::make_shared<Flatten>(std::make_tuple(28, 28));
+  std::shared_ptr<Layer> dropout = std::make_shared<Dropout>(0.2, 42);
+  std::shared_ptr<Layer> hidden =
+      std::make_shared<Dense>(128, ACTIVATION::RELU, WEIGHT_INIT::HE);
+  std::shared_ptr<Layer> output =
+      std::make_shared<Dense>(10, ACTIVATION::SOFTMAX, WEIGHT_INIT::LECUN);
+
+  network->addLayer(flatten);
+  network->addLayer(dropout);
+  network->addLayer(hidden);
+  network->addLayer(output);
+  network->setup(std::make_shared<Adam>(0.01), LOSS::MCE);
+
+  return network;
+}
+
+TEST_CASE("Data-parallel training epoch on MNIST sized samples",
+          "[benchmark]") {
+  const int nSamples = 2048;
+  Images images(nSamples, std::vector<std::vector<double>>(
+                              28, std::vector<double>(28)));
+  std::vector<double> labels(nSamples);
+
+  for (int i = 0; i < nSamples; i++) {
+    for (int r = 0; r < 28; r++) {
+      for (int c = 0; c < 28; c++) {
+        images[i][r][c] = ((i * 31 + r * 7 + c) % 256) / 255.0;
+      }
+    }
+    labels[i] = i % 10;
+  }
+
+  TrainingData<Images, std::vector<double>> trainingData(images, labels);
+  trainingData.batch(128);
+
+  for (int nThreads : {1, 2, 4, 8, 16}) {
+    std::shared_ptr<Network> network = mnistNetwork();
+    network->setTrainingMode(nThreads == 1 ? TRAINING_MODE::SEQUENTIAL
+                                           : TRAINING_MODE::DATA_PARALLEL,
+                             nThreads);
+
+    BENCHMARK(std::to_string(nThreads) + " thread(s)") {
+      return network->train(trainingData, 1, {}, false);
+    };
+  }
+}
+
+TEST_CASE("Asynchronous (HOGWILD) versus synchronous training on tabular data",
+          "[benchmark]") {
+  // Sparse-ish samples (~10% non-zero features), the class is given by the
+  // sign of a fixed linear combination
+  const int nSamples = 8192, nFeatures = 256;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> value(-1, 1);
+  std::bernoulli_distribution nonZero(0.1);
+  std::vector<std::vector<double>> samples(nSamples,
+                                           std::vector<double>(nFeatures, 0));
+  std::vector<double> labels(nSamples);
+
+  for (int i = 0; i < nSamples; i++) {
+    double score = 0;
+    for (int f = 0; f < nFeatures; f++) {
+      if (nonZero(gen)) samples[i][f] = value(gen);
+      score += samples[i][f] * ((f % 7) - 3);
+    }
+    labels[i] = score > 0;
+  }
+
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(samples, labels);
+  trainingData.batch(32);
+
+  auto tabularNetwork = [nFeatures](TRAINING_MODE mode, int nThreads) {
+    std::shared_ptr<Network> network = std::make_shared<Network>();
+    std::shared_ptr<Layer> input = std::make_shared<Dense>(nFeatures);
+    std::shared_ptr<Layer> hidden =
+        std::make_shared<Dense>(64, ACTIVATION::RELU, WEIGHT_INIT::HE);
+    std::shared_ptr<Layer> output =
+        std::make_shared<Dense>(2, ACTIVATION::SOFTMAX, WEIGHT_INIT::LECUN);
+
+    network->addLayer(input);
+    network->addLayer(hidden);
+    network->addLayer(output);
+    network->setup(std::make_shared<SGD>(0.05), LOSS::MCE);
+    network->setTrainingMode(mode, nThreads);
+    return network;
+  };
+
+  const std::vector<std::tuple<std::string, TRAINING_MODE, int>> modes = {
+      {"sequential", TRAINING_MODE::SEQUENTIAL, 1},
+      {"data-parallel x4", TRAINING_MODE::DATA_PARALLEL, 4},
+      {"hogwild x4", TRAINING_MODE::HOGWILD, 4},
+      {"hogwild x8", TRAINING_MODE::HOGWILD, 8},
+  };
+
+  // Convergence : loss after the same number of epochs
+  for (const auto &[name, mode, nThreads] : modes) {
+    std::shared_ptr<Network> network = tabularNetwork(mode, nThreads);
+    const double loss = network->train(trainingData, 5, {}, false);
+    std::cout << name << " : loss after 5 epochs = " << loss << std::endl;
+  }
+
+  // Throughput : duration of an epoch
+  for (const auto &[name, mode, nThreads] : modes) {
+    std::shared_ptr<Network> network = tabularNetwork(mode, nThreads);
+
+    BENCHMARK("Epoch (" + name + ")") {
+      return network->train(trainingData, 1, {}, false);
+    };
+  }
+}
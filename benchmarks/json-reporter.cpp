@@ -0,0 +1,86 @@
+#include <catch2/catch_test_case_info.hpp>
+#include <catch2/interfaces/catch_interfaces_reporter.hpp>
+#include <catch2/reporters/catch_reporter_registrars.hpp>
+#include <catch2/reporters/catch_reporter_streaming_base.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * Catch 2 reporter writing the benchmarks results as JSON, to track them over
+ * time (`--reporter benchmark-json --out results.json`, see the
+ * `run-benchmarks` target). The durations are in nanoseconds.
+ *
+ * {
+ *   "executable": "bench-optimizers",
+ *   "benchmarks": [
+ *     {"test_case": "...", "name": "SGD", "mean_ns": 1234.5,
+ *      "mean_low_ns": ..., "mean_high_ns": ..., "stddev_ns": ...,
+ *      "samples": 100, "iterations": 1},
+ *     ...
+ *   ]
+ * }
+ */
+class BenchmarkJsonReporter : public Catch::StreamingReporterBase {
+ public:
+  BenchmarkJsonReporter(Catch::ReporterConfig &&config)
+      : StreamingReporterBase(std::move(config)){};
+
+  static std::string getDescription() {
+    return "Reports the benchmarks results as JSON";
+  }
+
+  void benchmarkEnded(Catch::BenchmarkStats<> const &stats) override {
+    Result result;
+    result.testCase = currentTestCaseInfo ? currentTestCaseInfo->name : "";
+    result.name = stats.info.name;
+    result.mean = stats.mean.point.count();
+    result.meanLow = stats.mean.lower_bound.count();
+    result.meanHigh = stats.mean.upper_bound.count();
+    result.stddev = stats.standardDeviation.point.count();
+    result.samples = stats.info.samples;
+    result.iterations = stats.info.iterations;
+    results.push_back(result);
+  }
+
+  void testRunEnded(Catch::TestRunStats const &stats) override {
+    m_stream << "{\n  \"executable\": " << quote(currentTestRunInfo.name)
+             << ",\n  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); i++) {
+      const Result &r = results[i];
+      m_stream << (i ? ",\n" : "\n") << "    {\"test_case\": "
+               << quote(r.testCase) << ", \"name\": " << quote(r.name)
+               << ", \"mean_ns\": " << r.mean
+               << ", \"mean_low_ns\": " << r.meanLow
+               << ", \"mean_high_ns\": " << r.meanHigh
+               << ", \"stddev_ns\": " << r.stddev
+               << ", \"samples\": " << r.samples
+               << ", \"iterations\": " << r.iterations << "}";
+    }
+
+    m_stream << (results.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    m_stream.flush();
+    StreamingReporterBase::testRunEnded(stats);
+  }
+
+ private:
+  struct Result {
+    std::string testCase, name;
+    double mean, meanLow, meanHigh, stddev;
+    unsigned int samples;
+    int iterations;
+  };
+
+  std::vector<Result> results;
+
+  static std::string quote(const std::string &s) {
+    std::string quoted = "\"";
+    for (char c : s) {
+      if (c == '"' || c == '\\') quoted += '\\';
+      quoted += c;
+    }
+    return quoted + "\"";
+  }
+};
+
+CATCH_REGISTER_REPORTER("benchmark-json", BenchmarkJsonReporter)
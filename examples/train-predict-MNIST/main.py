@@ -6,7 +6,7 @@
   - Save the model in a binary file
 """
 
-import sys, random
+import sys
 import numpy as np
 from helpers.utils import *
 from halo import Halo
@@ -31,28 +31,20 @@ if not file_exists(MNIST_DATASET_FILE):
 network = NNP.models.Network()
 
 network.addLayer(NNP.layers.Flatten((28, 28)))
-network.addLayer(NNP.layers.Dropout(0.8))
+network.addLayer(NNP.layers.Dropout(0.2))
 network.addLayer(NNP.layers.Dense(128, NNP.ACTIVATION.RELU, NNP.WEIGHT_INIT.HE))
 network.addLayer(NNP.layers.Dense(10, NNP.ACTIVATION.SOFTMAX, NNP.WEIGHT_INIT.LECUN))
 
 # Setting up the networks parameters
 network.setup(optimizer=NNP.optimizers.Adam(0.01), loss=NNP.LOSS.MCE)
 
-# combining the data with the labels for later shuffling
-combined = list(zip(x_train, y_train))
+# preparing the training data, the uint8 pixels are read straight from the
+# arrays and scaled to [0, 1]
+trainingData = NNP.ArrayTrainingData(
+    x_train[:NUM_TRAININGS], y_train[:NUM_TRAININGS], scale=1.0 / 255
+)
 
-# shuffling the combined list
-random.shuffle(combined)
-
-# separating them
-x_train, y_train = zip(*combined)
-
-# preparing the training data
-f_x_train = [normalize_img(x) for x in x_train]
-
-trainingData = NNP.TrainingData3dI(f_x_train[:NUM_TRAININGS], y_train[:NUM_TRAININGS])
-
-trainingData.batch(128)
+trainingData.batch(128, shuffle=True)
 
 callbacks = [
     NNP.callbacks.EarlyStopping("LOSS", 0.01),
@@ -62,7 +54,7 @@ callbacks = [
 
 network.train(trainingData, 10, callbacks)
 
-f_x_test = [normalize_img(x) for x in x_test]
+f_x_test = x_test / 255.0
 
 # preparing the testing data
 predictions = network.predict(f_x_test[:NUM_PREDICTIONS])
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+
+#include "Network.hpp"
+
+namespace NeuralNet {
+/**
+ * Inference path that doesn't modify the network.
+ *
+ * A session owns the buffers of a forward pass (the layers' outputs) and only
+ * reads the network's layers, so several threads can each predict with their
+ * own session on the same network concurrently. The training-only layers
+ * (Dropout) are skipped.
+ *
+ * The inputs are checked against the network's input layer, invalid inputs
+ * throw `std::invalid_argument`.
+ *
+ * @note A single session must not be used by several threads at once, and the
+ * network mustn't be trained while sessions are predicting with it.
+ */
+class InferenceSession {
+ public:
+  /**
+   * @param network The network to predict with, it must outlive the session
+   */
+  explicit InferenceSession(const Network &network)
+      : network(network), outputs(network.getNumLayers()){};
+
+  /**
+   * @brief Feed forward the given inputs through the network
+   *
+   * @param inputs The inputs, one (flattened) sample per row
+   *
+   * @return A reference to the outputs of the network, valid until the
+   * session's next prediction
+   */
+  const Matrix &predict(const ConstMatrixRef &inputs) {
+    checkInputs(inputs.rows(), inputs.cols());
+    const std::vector<std::shared_ptr<Layer>> &layers = network.layers;
+    const Matrix *prevOutputs = nullptr;
+    // Layers added since the session was created
+    if (outputs.size() != layers.size()) outputs.resize(layers.size());
+
+    // The input layer (Dense or Flatten) passes the inputs as they are
+    for (size_t l = 1; l < layers.size(); l++) {
+      const Layer &cLayer = *layers[l];
+      if (cLayer.trainingOnly) continue;
+
+      if (cLayer.type != LayerType::DENSE)
+        throw std::invalid_argument(
+            "Only Dense layers can follow the input layer");
+      const Dense &cDense = static_cast<const Dense &>(cLayer);
+
+      if (prevOutputs)
+        cDense.forward(*prevOutputs, outputs[l], nullptr);
+      else
+        cDense.forward(inputs, outputs[l], nullptr);
+
+      prevOutputs = &outputs[l];
+    }
+
+    if (prevOutputs) return *prevOutputs;
+
+    outputs[0] = inputs;
+    return outputs[0];
+  }
+
+  /**
+   * @brief Feed forward the given inputs through the network
+   *
+   * @param inputs The inputs, one sample per vector (or one input per vector,
+   * the samples as columns)
+   *
+   * @return A reference to the outputs of the network, valid until the
+   * session's next prediction
+   */
+  const Matrix &predict(const std::vector<std::vector<double>> &inputs) {
+    if (inputs.empty()) throw std::invalid_argument("No samples to predict");
+    const size_t width = inputs[0].size();
+    samples.resize(inputs.size(), width);
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+      if (inputs[i].size() != width)
+        throw std::invalid_argument("The samples don't have the same size");
+      samples.row(i) =
+          Eigen::RowVectorXd::Map(inputs[i].data(), width).cast<Scalar>();
+    }
+
+    // Samples passed as columns
+    const size_t nInputs = inputLayer().getNumNeurons();
+    if (width != nInputs && inputs.size() == nInputs)
+      samples.transposeInPlace();
+
+    return predict(samples);
+  }
+
+  /**
+   * @brief Feed forward the given inputs through the network, the input layer
+   * must be a `Flatten` layer
+   *
+   * @param inputs The inputs, one 2D sample per element
+   *
+   * @return A reference to the outputs of the network, valid until the
+   * session's next prediction
+   */
+  const Matrix &predict(
+      const std::vector<std::vector<std::vector<double>>> &inputs) {
+    if (inputLayer().type != LayerType::FLATTEN)
+      throw std::invalid_argument(
+          "Cannot feed 3d vectors, a Flatten layer could do it though");
+    const Flatten &flatten = static_cast<const Flatten &>(inputLayer());
+
+    const auto [rows, cols] = flatten.getInputShape();
+    for (const std::vector<std::vector<double>> &input : inputs) {
+      bool sameShape = input.size() == static_cast<size_t>(rows);
+      for (const std::vector<double> &row : input)
+        sameShape = sameShape && row.size() == static_cast<size_t>(cols);
+      if (!sameShape)
+        throw std::invalid_argument(
+            "The samples shape doesn't match the network's inputs");
+    }
+
+    flatten.flattenInto(inputs, samples);
+    return predict(samples);
+  }
+
+  /**
+   * @brief Feed forward the given inputs through the network
+   *
+   * @param inputs A view over the inputs (ex: a NumPy array), one sample per
+   * row
+   *
+   * @return A reference to the outputs of the network, valid until the
+   * session's next prediction
+   */
+  const Matrix &predict(const ArrayView &inputs) {
+    checkInputs(inputs.rows, inputs.cols);
+    inputs.readAll(samples);
+    return predict(samples);
+  }
+
+ private:
+  const Network &network;
+  std::vector<Matrix> outputs;  // Outputs of each layer
+  Matrix samples;  // Inputs converted from vectors or arrays
+
+  const Layer &inputLayer() const {
+    if (network.layers.empty())
+      throw std::invalid_argument("The network doesn't have any layer");
+    return *network.layers[0];
+  }
+
+  /**
+   * Throws when the samples can't be fed to the network
+   */
+  void checkInputs(Eigen::Index rows, Eigen::Index cols) const {
+    if (rows == 0) throw std::invalid_argument("No samples to predict");
+    if (cols != inputLayer().getNumNeurons())
+      throw std::invalid_argument(
+          "The samples size doesn't match the network's inputs");
+  }
+};
+}  // namespace NeuralNet
@@ -1,19 +1,96 @@
 #include "Network.hpp"
 
+#include "InferenceSession.hpp"
+
 using namespace NeuralNet;
 
+namespace {
+/**
+ * Applies a learning rate schedule to the optimizer during a training, the
+ * optimizer gets its base rate back when the training is over (even when
+ * it's interrupted)
+ */
+class ScheduledRate {
+ public:
+  ScheduledRate(Optimizer &optimizer, LRScheduler *scheduler)
+      : optimizer(optimizer),
+        scheduler(scheduler),
+        baseRate(optimizer.getAlpha()) {
+    if (scheduler) scheduler->reset();
+  };
+
+  ~ScheduledRate() { optimizer.setAlpha(baseRate); }
+
+  void onEpochBegin(int epoch) {
+    if (scheduler && !scheduler->isPerBatch())
+      optimizer.setAlpha(scheduler->getRate(epoch, baseRate));
+  }
+
+  void onBatchBegin() {
+    if (scheduler && scheduler->isPerBatch())
+      optimizer.setAlpha(scheduler->getRate(step++, baseRate));
+  }
+
+  void onEpochEnd(double loss) {
+    if (scheduler) scheduler->onEpochEnd(loss);
+  }
+
+ private:
+  Optimizer &optimizer;
+  LRScheduler *scheduler;
+  double baseRate;
+  int step = 0;  // Batches since the training began
+};
+
+/**
+ * Throws when the HOGWILD training can't train with the given optimizer or
+ * learning rate schedule
+ */
+void checkHogwildSetup(TRAINING_MODE mode, const Optimizer *optimizer,
+                       const LRScheduler *scheduler) {
+  if (mode != TRAINING_MODE::HOGWILD) return;
+  // Updates without the other workers' gradients only make sense for SGD
+  if (optimizer && !dynamic_cast<const SGD *>(optimizer))
+    throw std::invalid_argument("HOGWILD training requires the SGD optimizer");
+  // The workers share the optimizer, its rate can only change between epochs
+  if (scheduler && scheduler->isPerBatch())
+    throw std::invalid_argument(
+        "HOGWILD training only supports per-epoch learning rate schedules");
+}
+}  // namespace
+
 Network::Network(){};
 
 size_t Network::getNumLayers() const { return this->layers.size(); }
 
 void Network::setup(const std::shared_ptr<Optimizer> &optimizer, LOSS loss) {
+  checkHogwildSetup(trainingMode, optimizer.get(), scheduler.get());
   this->optimizer = optimizer;
   this->lossFunc = loss;
   this->setLoss(loss);
-  this->updateOptimizerSetup(this->layers.size());
+  this->updateOptimizerSetup();
   this->registerSignals();  // Allows smooth exit of program
 }
 
+void Network::setTrainingMode(TRAINING_MODE mode, int nThreads) {
+  assert(nThreads >= 0);
+  checkHogwildSetup(mode, optimizer.get(), scheduler.get());
+  this->trainingMode = mode;
+  this->nThreads =
+      nThreads > 0 ? nThreads
+                   : std::max(1, static_cast<int>(
+                                     std::thread::hardware_concurrency()));
+}
+
+void Network::setUpdateSchedule(UPDATE_SCHEDULE schedule) {
+  this->updateSchedule = schedule;
+}
+
+void Network::setScheduler(const std::shared_ptr<LRScheduler> &scheduler) {
+  checkHogwildSetup(trainingMode, optimizer.get(), scheduler.get());
+  this->scheduler = scheduler;
+}
+
 void Network::addLayer(std::shared_ptr<Layer> &layer) {
   size_t numLayers = this->layers.size();
   // Init layer with right amount of weights
@@ -23,6 +100,39 @@ void Network::addLayer(std::shared_ptr<Layer> &layer) {
   }
 
   this->layers.push_back(layer);
+  packParameters();
+}
+
+void Network::packParameters() {
+  size_t size = 0;
+  for (const std::shared_ptr<Layer> &layer : this->layers) {
+    if (layer->type == LayerType::DENSE)
+      size += static_cast<const Dense &>(*layer).getNumParameters();
+  }
+
+  parameters = std::make_shared<ParameterArena>(size);
+  stepParameters.clear();
+
+  // The blocks follow the order of the layers
+  size_t offset = 0;
+  for (const std::shared_ptr<Layer> &layer : this->layers) {
+    if (layer->type != LayerType::DENSE) continue;
+    Dense &dense = static_cast<Dense &>(*layer);
+    dense.bindParameters(parameters, offset);
+    offset += dense.getNumParameters();
+
+    if (dense.nInputs == 0) continue;
+    const ParameterMap gradW = dense.weightsGradient(parameters->gradients());
+    const ParameterMap gradB = dense.biasesGradient(parameters->gradients());
+    stepParameters.push_back(
+        {dense.weights, ConstParameterMap(gradW.data(), gradW.rows(),
+                                          gradW.cols())});
+    stepParameters.push_back(
+        {dense.biases, ConstParameterMap(gradB.data(), gradB.rows(),
+                                         gradB.cols())});
+  }
+
+  if (this->optimizer) this->updateOptimizerSetup();
 }
 
 void Network::setLoss(LOSS loss) {
@@ -73,7 +183,10 @@ double Network::train(std::vector<std::vector<double>> X, std::vector<double> y,
                       bool progBar) {
   this->progBar = progBar;
   try {
-    return onlineTraining(X, y, epochs, callbacks);
+    const Matrix x = vectorToMatrixXd(X);
+    const Matrix yM = formatLabels(
+        y, {x.rows(), this->getOutputLayer()->getNumNeurons()});
+    return onlineTraining(x, yM, epochs, callbacks);
   } catch (const std::exception &e) {
     trainingCheckpoint("onTrainEnd", callbacks);
     std::cerr << "Training Interrupted : " << e.what() << '\n';
@@ -87,7 +200,12 @@ double Network::train(std::vector<std::vector<std::vector<double>>> X,
                       bool progBar) {
   this->progBar = progBar;
   try {
-    return onlineTraining(X, y, epochs, callbacks);
+    // Flattened by the input layer
+    this->layers[0]->feedInputs(X);
+    const Matrix x = this->layers[0]->getOutputs();
+    const Matrix yM = formatLabels(
+        y, {x.rows(), this->getOutputLayer()->getNumNeurons()});
+    return onlineTraining(x, yM, epochs, callbacks);
   } catch (const std::exception &e) {
     trainingCheckpoint("onTrainEnd", callbacks);  // wrap up callbacks
     std::cerr << "Training Interrupted : " << e.what() << '\n';
@@ -95,10 +213,36 @@ double Network::train(std::vector<std::vector<std::vector<double>>> X,
   }
 }
 
+double Network::train(const ArrayView &inputs, const ArrayView &labels,
+                      int epochs,
+                      std::vector<std::shared_ptr<Callback>> callbacks,
+                      bool progBar) {
+  this->progBar = progBar;
+  try {
+    if (inputs.rows == 0)
+      throw std::invalid_argument("There are no samples to train on");
+    if (inputs.cols != this->layers[0]->getNumNeurons())
+      throw std::invalid_argument(
+          "The samples size doesn't match the network's inputs");
+
+    // Read (and the labels checked) as a single batch in the samples order
+    ArrayTrainingData trainingData(inputs, labels);
+    trainingData.batch(trainingData.getNumSamples());
+    Matrix x, y;
+    trainingData.gatherInputs(0, x);
+    trainingData.gatherLabels(0, y, this->getOutputLayer()->getNumNeurons());
+    return onlineTraining(x, y, epochs, callbacks);
+  } catch (const std::exception &e) {
+    trainingCheckpoint("onTrainEnd", callbacks);
+    std::cerr << "Training Interrupted : " << e.what() << '\n';
+    return loss;
+  }
+}
+
 // Specific implementation of train that takes TrainingData class as input
 double Network::train(
     TrainingData<std::vector<std::vector<double>>, std::vector<double>>
-        trainingData,
+        &trainingData,
     int epochs, std::vector<std::shared_ptr<Callback>> callbacks,
     bool progBar) {
   this->progBar = progBar;
@@ -113,8 +257,7 @@ double Network::train(
 
 double Network::train(
     TrainingData<std::vector<std::vector<std::vector<double>>>,
-                 std::vector<double>>
-        trainingData,
+                 std::vector<double>> &trainingData,
     int epochs, std::vector<std::shared_ptr<Callback>> callbacks,
     bool progBar) {
   this->progBar = progBar;
@@ -127,65 +270,121 @@ double Network::train(
   }
 }
 
+double Network::train(MappedTrainingData &trainingData, int epochs,
+                      std::vector<std::shared_ptr<Callback>> callbacks,
+                      bool progBar) {
+  this->progBar = progBar;
+  try {
+    if (!trainingData.batched)
+      throw std::runtime_error(
+          "MappedTrainingData must be batched before training");
+    return this->miniBatchTraining(trainingData, epochs, callbacks);
+  } catch (const std::exception &e) {
+    trainingCheckpoint("onTrainEnd", callbacks);
+    std::cerr << "Training Interrupted : " << e.what() << '\n';
+    return loss;
+  }
+}
+
+double Network::train(ArrayTrainingData &trainingData, int epochs,
+                      std::vector<std::shared_ptr<Callback>> callbacks,
+                      bool progBar) {
+  this->progBar = progBar;
+  try {
+    if (!trainingData.batched)
+      trainingData.batch(trainingData.getNumSamples());
+    return this->miniBatchTraining(trainingData, epochs, callbacks);
+  } catch (const std::exception &e) {
+    trainingCheckpoint("onTrainEnd", callbacks);
+    std::cerr << "Training Interrupted : " << e.what() << '\n';
+    return loss;
+  }
+}
+
 template <typename D1, typename D2>
-double Network::trainer(TrainingData<D1, D2> trainingData, int epochs,
-                        std::vector<std::shared_ptr<Callback>> callbacks) {
+double Network::trainer(
+    TrainingData<D1, D2> &trainingData, int epochs,
+    const std::vector<std::shared_ptr<Callback>> &callbacks) {
   if (trainingData.batched)
     return this->miniBatchTraining(trainingData, epochs, callbacks);
   return this->batchTraining(trainingData, epochs, callbacks);
 }
 
-template <typename D1, typename D2>
+template <typename Data>
 double Network::miniBatchTraining(
-    TrainingData<D1, D2> trainingData, int epochs,
-    std::vector<std::shared_ptr<Callback>> callbacks) {
+    Data &trainingData, int epochs,
+    const std::vector<std::shared_ptr<Callback>> &callbacks) {
+  if (trainingMode == TRAINING_MODE::HOGWILD)
+    return this->hogwildTraining(trainingData, epochs, callbacks);
+
   double sumLoss = 0;
   const int nOutputs = getOutputLayer()->getNumNeurons();
-  D1 xTest = trainingData.xTest;
-  D2 yTest = trainingData.yTest;
-
-  // Formatting and caching test labels
-  Eigen::MatrixXd yTestM = !yTest.empty()
-                               ? formatLabels(yTest, {yTest.size(), nOutputs})
-                               : Eigen::MatrixXd::Zero(1, 1);
+  const int nBatches = trainingData.getNumBatches();
+  const bool hasTestData = trainingData.hasTestData();
+
+  // Gathering and caching test data
+  Matrix xTest, yTestM;
+  if (hasTestData) trainingData.gatherTestData(xTest, yTestM, nOutputs);
+
+  // Prepares the batches, in the background when prefetching is enabled
+  BatchPrefetcher<Data> prefetcher(trainingData, nOutputs,
+                                   trainingData.prefetchDepth,
+                                   trainingData.prefetchWorkers);
+  // Data-parallel workers, or the workers of the update when it's done after
+  // the backpropagation (the calling thread being one of them)
+  const bool dataParallel = trainingMode == TRAINING_MODE::DATA_PARALLEL;
+  const bool parallelUpdate = updateSchedule == UPDATE_SCHEDULE::AFTER_BACKPROP;
+  WorkerPool pool(dataParallel || parallelUpdate ? nThreads : 1);
+  if (nBatches > 0)
+    initWorkspace(trainingData.getBatchSize(0), dataParallel ? pool.size() : 0);
+  ScheduledRate rate(*this->optimizer, scheduler.get());
   trainingCheckpoint("onTrainBegin", callbacks);
 
   // Epoch loop
   for (cEpoch = 0; cEpoch < epochs; cEpoch++) {
     double sumBatchLoss = 0;
-    int nBatches = trainingData.miniBatches.size();
+    // Draw new batches (only when reshuffling is enabled)
+    if (cEpoch > 0) trainingData.nextEpoch();
+    prefetcher.startEpoch();
+    rate.onEpochBegin(cEpoch);
     trainingCheckpoint("onEpochBegin", callbacks);
     TrainingGauge g(nBatches, 0, epochs, (cEpoch + 1));
 
     // Batch loop
     for (int b = 0; b < nBatches; b++) {
+      rate.onBatchBegin();
       trainingCheckpoint("onBatchBegin", callbacks);
-      auto &xTrain = trainingData.miniBatches[b].first;
-      auto &yTrain = trainingData.miniBatches[b].second;
-      const int nInputs = xTrain.size();
-      Eigen::MatrixXd y = formatLabels(yTrain, {nInputs, nOutputs});
+      Batch &batch = prefetcher.acquire();
+
+      if (dataParallel) {
+        this->dataParallelStep(batch.x, batch.y, pool);
+      } else {
+        const int nInputs = batch.x.rows();
 
-      // computing outputs from forward propagation
-      Eigen::MatrixXd o = this->forwardProp(xTrain, true);
+        // computing outputs from forward propagation
+        const Matrix &o = this->forwardProp(batch.x, true);
 
-      loss = this->cmpLoss(o, y) / nInputs;
-      accuracy = computeAccuracy(o, y);
+        loss = computeLoss(o, batch.y) / nInputs;
+        accuracy = computeAccuracy(o, batch.y);
+        this->backProp(o, batch.y, &pool);
+      }
       sumBatchLoss += loss;
       sumLoss += loss;
-      this->backProp(o, y);
+      prefetcher.release();
       trainingCheckpoint("onBatchEnd", callbacks);
       if (!this->progBar) continue;  // Skip when disabled
       g.printWithLAndA(loss, accuracy);
     }
     // predict and calculate test metrics if present
-    if (!yTest.empty() && !yTestM.isZero(0)) {
-      Eigen::MatrixXd oTest = this->forwardProp(xTest);
+    if (hasTestData) {
+      const Matrix &oTest = this->forwardProp(xTest);
       testLoss =
-          this->cmpLoss(oTest, yTestM) / static_cast<double>(xTest.size());
+          computeLoss(oTest, yTestM) / static_cast<double>(xTest.rows());
       testAccuracy = computeAccuracy(oTest, yTestM);
     }
     // calculating current epoch avg loss
-    loss = sumBatchLoss / static_cast<double>(nBatches);
+    loss = sumBatchLoss / static_cast<double>(std::max(nBatches, 1));
+    rate.onEpochEnd(hasTestData ? testLoss : loss);
     trainingCheckpoint("onEpochEnd", callbacks);
   }
 
@@ -193,40 +392,160 @@ double Network::miniBatchTraining(
   return loss;
 }
 
-template <typename D1, typename D2>
-double Network::batchTraining(
-    TrainingData<D1, D2> trainingData, int epochs,
-    std::vector<std::shared_ptr<Callback>> callbacks) {
-  double sumLoss = 0;
-  const int nOutputs = this->getOutputLayer()->getNumNeurons();
-  const int nInputs = trainingData.xTrain.size();
-  D1 xTest = trainingData.xTest;
-  D2 yTest = trainingData.yTest;
-
-  // Formatting and caching test labels
-  Eigen::MatrixXd yTestM = !yTest.empty()
-                               ? formatLabels(yTest, {yTest.size(), nOutputs})
-                               : Eigen::MatrixXd::Zero(1, 1);
-  Eigen::MatrixXd y = formatLabels(trainingData.yTrain, {nInputs, nOutputs});
+template <typename Data>
+double Network::hogwildTraining(
+    Data &trainingData, int epochs,
+    const std::vector<std::shared_ptr<Callback>> &callbacks) {
+  // Checked by the setters already, the optimizer may have been changed since
+  checkHogwildSetup(trainingMode, this->optimizer.get(), scheduler.get());
+
+  const int nOutputs = getOutputLayer()->getNumNeurons();
+  const int nBatches = trainingData.getNumBatches();
+  const bool hasTestData = trainingData.hasTestData();
+  const size_t nLayers = this->layers.size();
+
+  // Gathering and caching test data
+  Matrix xTest, yTestM;
+  if (hasTestData) trainingData.gatherTestData(xTest, yTestM, nOutputs);
+
+  // Every worker trains on whole batches
+  WorkerPool pool(nThreads);
+  const int batchSize = nBatches > 0 ? trainingData.getBatchSize(0) : 0;
+  initWorkspace(batchSize, pool.size(), true);
+
+  // Each worker draws its own dropout masks
+  std::vector<Philox> generators;
+  for (int w = 0; w < pool.size(); w++) {
+    generators.push_back(randomGenerator());
+  }
+
+  std::vector<double> sumLosses(pool.size()), sumAccuracies(pool.size());
+  // The batch callbacks are called by the workers, one at a time
+  std::mutex callbacksMutex;
+  ScheduledRate rate(*this->optimizer, scheduler.get());
   trainingCheckpoint("onTrainBegin", callbacks);
 
   for (cEpoch = 0; cEpoch < epochs; cEpoch++) {
+    if (cEpoch > 0) trainingData.nextEpoch();
+    rate.onEpochBegin(cEpoch);
     trainingCheckpoint("onEpochBegin", callbacks);
     TrainingGauge g(1, 0, epochs, (cEpoch + 1));
-    Eigen::MatrixXd o = this->forwardProp(trainingData.xTrain, true);
+    std::atomic<int> nextBatch{0};
+
+    // Each worker trains on the next available batch and updates the shared
+    // parameters without any lock, the other workers may read them meanwhile
+    pool.run([&](int w) {
+      Workspace &ws = workerSpaces[w];
+      sumLosses[w] = sumAccuracies[w] = 0;
+
+      for (int b = nextBatch++; b < nBatches; b = nextBatch++) {
+        if (!callbacks.empty()) {
+          std::lock_guard<std::mutex> lock(callbacksMutex);
+          trainingCheckpoint("onBatchBegin", callbacks);
+        }
+        trainingData.gatherInputs(b, ws.outputs[0]);
+        trainingData.gatherLabels(b, ws.y, nOutputs);
+        const int n = ws.y.rows();
+
+        for (size_t l = 1; l < nLayers; l++) {
+          if (this->layers[l]->type != LayerType::DROPOUT) continue;
+          const Dropout &doLayer =
+              static_cast<const Dropout &>(*this->layers[l]);
+          doLayer.drawMask(n, doLayer.getNumNeurons(), generators[w],
+                           ws.masks[l]);
+        }
+
+        workerPass(ws);
+        sumLosses[w] += ws.loss / n;
+        sumAccuracies[w] += ws.accuracy;
+
+        const Scalar scale = 1.0 / n;
+        for (size_t i = nLayers; --i > 0;) {
+          if (this->layers[i]->type != LayerType::DENSE) continue;
+          Dense &cDense = static_cast<Dense &>(*this->layers[i]);
+          ParameterMap gradW = cDense.weightsGradient(ws.grads.data());
+          ParameterMap gradB = cDense.biasesGradient(ws.grads.data());
+          gradW *= scale;
+          gradB *= scale;
+          this->optimizer->updateWeights(cDense.weights, gradW);
+          this->optimizer->updateBiases(cDense.biases, gradB);
+        }
+
+        if (!callbacks.empty()) {
+          // The callbacks see the metrics of the batch the worker trained on
+          std::lock_guard<std::mutex> lock(callbacksMutex);
+          loss = ws.loss / n;
+          accuracy = ws.accuracy;
+          trainingCheckpoint("onBatchEnd", callbacks);
+        }
+      }
+    });
+
+    // Summing the workers' metrics in order
+    double sumBatchLoss = 0, sumBatchAccuracy = 0;
+    for (int w = 0; w < pool.size(); w++) {
+      sumBatchLoss += sumLosses[w];
+      sumBatchAccuracy += sumAccuracies[w];
+    }
+    // No batches (ex: less samples than a batch with dropLast), no metrics
+    const double nDone = std::max(nBatches, 1);
+    loss = sumBatchLoss / nDone;
+    accuracy = sumBatchAccuracy / nDone;
 
     // predict and calculate test metrics if present
-    if (!yTest.empty() && !yTestM.isZero(0)) {
-      Eigen::MatrixXd oTest = this->forwardProp(xTest, true);
-      testLoss = this->cmpLoss(oTest, yTestM);
+    if (hasTestData) {
+      const Matrix &oTest = this->forwardProp(xTest);
+      testLoss =
+          computeLoss(oTest, yTestM) / static_cast<double>(xTest.rows());
       testAccuracy = computeAccuracy(oTest, yTestM);
     }
+    rate.onEpochEnd(hasTestData ? testLoss : loss);
+    trainingCheckpoint("onEpochEnd", callbacks);
+    if (!this->progBar) continue;  // Skip when disabled
+    g.printWithLAndA(loss, accuracy);
+  }
+
+  trainingCheckpoint("onTrainEnd", callbacks);
+  return loss;
+}
 
-    loss = this->cmpLoss(o, y) / nInputs;
+template <typename D1, typename D2>
+double Network::batchTraining(
+    TrainingData<D1, D2> &trainingData, int epochs,
+    const std::vector<std::shared_ptr<Callback>> &callbacks) {
+  double sumLoss = 0;
+  const int nOutputs = this->getOutputLayer()->getNumNeurons();
+  const int nInputs = trainingData.xTrain.rows();
+  const bool hasTestData = trainingData.hasTestData();
+
+  // Gathering and caching test data
+  Matrix xTest, yTestM;
+  if (hasTestData) trainingData.gatherTestData(xTest, yTestM, nOutputs);
+  Matrix x = trainingData.xTrain;
+  Matrix y(nInputs, nOutputs);
+  for (int i = 0; i < nInputs; i++)
+    trainingData.writeLabel(trainingData.yTrain[i], y, i);
+  initWorkspace(nInputs);
+  trainingCheckpoint("onTrainBegin", callbacks);
+
+  for (cEpoch = 0; cEpoch < epochs; cEpoch++) {
+    trainingCheckpoint("onEpochBegin", callbacks);
+    TrainingGauge g(1, 0, epochs, (cEpoch + 1));
+    const Matrix &o = this->forwardProp(x, true);
+
+    loss = computeLoss(o, y) / nInputs;
     accuracy = computeAccuracy(o, y);
     sumLoss += loss;
 
     this->backProp(o, y);
+
+    // predict and calculate test metrics if present (after the update since
+    // the layers' outputs buffers are overwritten by the test pass)
+    if (hasTestData) {
+      const Matrix &oTest = this->forwardProp(xTest);
+      testLoss = computeLoss(oTest, yTestM);
+      testAccuracy = computeAccuracy(oTest, yTestM);
+    }
     trainingCheckpoint("onEpochEnd", callbacks);
     if (!this->progBar) continue;  // Skip when disabled
     g.printWithLAndA(loss, accuracy);
@@ -236,25 +555,23 @@ double Network::batchTraining(
   return sumLoss / nInputs;
 }
 
-template <typename D1, typename D2>
 double Network::onlineTraining(
-    std::vector<D1> inputs, std::vector<D2> labels, int epochs,
-    std::vector<std::shared_ptr<Callback>> callbacks) {
+    const Matrix &x, const Matrix &y, int epochs,
+    const std::vector<std::shared_ptr<Callback>> &callbacks) {
   double sumLoss = 0;
   int tCorrect = 0;
-  const int numOutputs = this->getOutputLayer()->getNumNeurons();
-  const int numInputs = inputs.size();
-  Eigen::MatrixXd y = formatLabels(labels, {numInputs, numOutputs});
+  const int numInputs = x.rows();
+  initWorkspace(numInputs);
 
   // Injecting callbacks
   trainingCheckpoint("onTrainBegin", callbacks);
 
   for (cEpoch = 0; cEpoch < epochs; cEpoch++) {
     trainingCheckpoint("onEpochBegin", callbacks);
-    TrainingGauge tg(inputs.size(), 0, epochs, (cEpoch + 1));
-    for (auto &input : inputs) {
-      Eigen::MatrixXd o = this->forwardProp(inputs, true);
-      loss = this->cmpLoss(o, y);
+    TrainingGauge tg(numInputs, 0, epochs, (cEpoch + 1));
+    for (int i = 0; i < numInputs; i++) {
+      const Matrix &o = this->forwardProp(x, true);
+      loss = computeLoss(o, y);
       sumLoss += loss;
       tCorrect += computeAccuracy(o, y);
       this->backProp(o, y);
@@ -271,134 +588,303 @@ double Network::onlineTraining(
   return sumLoss / numInputs;
 }
 
-Eigen::MatrixXd Network::predict(std::vector<std::vector<double>> inputs) {
-  Eigen::MatrixXd mInputs = vectorToMatrixXd(inputs);
-  return forwardProp(mInputs);
+Matrix Network::predict(std::vector<std::vector<double>> inputs) const {
+  InferenceSession session(*this);
+  return session.predict(inputs);
 }
 
-Eigen::MatrixXd Network::predict(
-    std::vector<std::vector<std::vector<double>>> inputs) {
-  return forwardProp(inputs);
+Matrix Network::predict(
+    std::vector<std::vector<std::vector<double>>> inputs) const {
+  InferenceSession session(*this);
+  return session.predict(inputs);
+}
+
+Matrix Network::predict(const ArrayView &inputs) const {
+  InferenceSession session(*this);
+  return session.predict(inputs);
 }
 
 /**
  * Forward propagation
  */
-Eigen::MatrixXd Network::feedForward(Eigen::MatrixXd inputs, int startIdx,
-                                     bool training) {
+const Matrix &Network::feedForward(const Matrix &inputs, int startIdx,
+                                   bool training) {
   assert(startIdx < this->layers.size());
-  Eigen::MatrixXd prevLayerOutputs = inputs;
+  // Each layer is fed the previous layer's outputs buffer, nothing is copied
+  const Matrix *prevLayerOutputs = &inputs;
 
   for (int l = startIdx; l < this->layers.size(); l++) {
     Layer &cLayer = *this->layers[l];
     if (cLayer.trainingOnly && !training) continue;
-    prevLayerOutputs = cLayer.feedInputs(prevLayerOutputs, training);
+    prevLayerOutputs = &cLayer.feedInputs(*prevLayerOutputs, training);
   }
 
-  return prevLayerOutputs;
+  return *prevLayerOutputs;
 }
 
-Eigen::MatrixXd Network::forwardProp(
-    std::vector<std::vector<std::vector<double>>> &inputs, bool training) {
+const Matrix &Network::forwardProp(
+    const std::vector<std::vector<std::vector<double>>> &inputs,
+    bool training) {
   // Passing the inputs as outputs to the input layer
   this->layers[0]->feedInputs(inputs);
 
-  Eigen::MatrixXd prevLayerOutputs = this->layers[0]->getOutputs();
-
-  return feedForward(prevLayerOutputs, 1, training);
+  return feedForward(this->layers[0]->getOutputs(), 1, training);
 }
 
-Eigen::MatrixXd Network::forwardProp(std::vector<std::vector<double>> &inputs,
-                                     bool training) {
+const Matrix &Network::forwardProp(
+    const std::vector<std::vector<double>> &inputs, bool training) {
   // Previous layer outputs
-  Eigen::MatrixXd prevLayerO = vectorToMatrixXd(inputs);
+  const Matrix prevLayerO = vectorToMatrixXd(inputs);
 
   return feedForward(prevLayerO, 0, training);
 }
 
-Eigen::MatrixXd Network::forwardProp(Eigen::MatrixXd &inputs, bool training) {
-  // Previous layer outputs
-  Eigen::MatrixXd prevLayerO = inputs;
+const Matrix &Network::forwardProp(const Matrix &inputs, bool training) {
+  return feedForward(inputs, 0, training);
+}
 
-  return feedForward(prevLayerO, 0, training);
+void Network::initWorkspace(int batchSize, int nWorkers, bool wholeBatches) {
+  std::vector<int> layerSizes;
+  layerSizes.reserve(this->layers.size());
+
+  for (const std::shared_ptr<Layer> &layer : this->layers) {
+    layerSizes.push_back(layer->getNumNeurons());
+  }
+
+  workspace.init(layerSizes, batchSize);
+  const size_t nParameters = parameters->getSize();
+
+  // Softmax output layer trained with the MCE : fused output head
+  Dense *outputLayer = dynamic_cast<Dense *>(this->layers.back().get());
+  fusedHead = lossFunc == LOSS::MCE && outputLayer &&
+              outputLayer->activation == ACTIVATION::SOFTMAX;
+  if (outputLayer) outputLayer->keepLogits = fusedHead;
+
+  // Each worker gets a shard of at most ceil(batchSize / nWorkers) samples,
+  // or whole batches
+  const int workerBatchSize =
+      wholeBatches || nWorkers == 0 ? batchSize
+                                    : (batchSize + nWorkers - 1) / nWorkers;
+  workerSpaces.resize(nWorkers);
+  for (Workspace &ws : workerSpaces) {
+    ws.init(layerSizes, workerBatchSize, true, nParameters);
+  }
+}
+
+double Network::computeLoss(const Matrix &outputs, const Matrix &y) {
+  if (!fusedHead) return this->cmpLoss(outputs, y);
+
+  // Stable loss from the logits kept by the output layer
+  const Dense &outputLayer = static_cast<const Dense &>(*this->layers.back());
+  return SoftmaxMCE::cmpLoss(outputLayer.logits, y);
 }
 
-void Network::backProp(Eigen::MatrixXd &outputs, Eigen::MatrixXd &y) {
-  // Next Layer activation der dL/da(l - 1)
-  Eigen::MatrixXd beta = this->cmpLossGrad(outputs, y);
-  int m = beta.rows();
+void Network::backProp(const Matrix &outputs, const Matrix &y,
+                       WorkerPool *pool) {
+  if (workspace.size() != this->layers.size()) initWorkspace(outputs.rows());
 
-  for (size_t i = this->layers.size(); --i > 0;) {
+  const size_t nLayers = this->layers.size();
+  const int m = outputs.rows();
+  const Scalar scale = 1.0 / m;
+
+  // Next Layer activation der dL/da(l - 1), the fused head directly yields
+  // the output layer's delta
+  Matrix *beta = &workspace.beta[nLayers - 1];
+  if (!fusedHead) this->cmpLossGrad(outputs, y, *beta);
+
+  const bool perLayer = updateSchedule == UPDATE_SCHEDULE::PER_LAYER;
+  if (perLayer) this->optimizer->beginStep();
+
+  for (size_t i = nLayers; --i > 0;) {
     Layer &cLayer = *this->layers[i];
     Layer &nLayer = *this->layers[i - 1];
 
-    Eigen::MatrixXd nLayerOutputs = nLayer.getOutputs();
+    const Matrix *nLayerOutputs = &nLayer.getOutputs();
 
     Dense *cDense = dynamic_cast<Dense *>(&cLayer);
 
-    if (!cDense || !nLayerOutputs.cols() || !nLayerOutputs.rows()) continue;
+    if (!cDense || !nLayerOutputs->cols() || !nLayerOutputs->rows()) continue;
 
-    if (nLayer.type == LayerType::DROPOUT) {
-      // dropout layer
-      Dropout *doLayer = dynamic_cast<Dropout *>(&nLayer);
+    Matrix &delta = workspace.delta[i];
+    ParameterMap gradW = cDense->weightsGradient(parameters->gradients());
+    ParameterMap gradB = cDense->biasesGradient(parameters->gradients());
 
-      assert(doLayer);
-      // rescale outputs
-      nLayerOutputs = nLayerOutputs.array() * doLayer->mask.array();
-      nLayerOutputs /= doLayer->scaleRate;
+    if (fusedHead && i == nLayers - 1) {
+      // dL/dZ(L) = p - y
+      SoftmaxMCE::cmpLossGrad(outputs, y, delta);
+    } else {
+      // dL/dA(L) . a'(L), without materializing a'(L)
+      delta.resize(beta->rows(), beta->cols());
+      cDense->backward(*beta, delta);
     }
 
-    // a'(L)
-    Eigen::MatrixXd aDer = cDense->diff(cDense->outputs);
+    gradW.noalias() = scale * (nLayerOutputs->transpose() * delta);
 
-    // a(L - 1) . a'(L)
-    Eigen::MatrixXd delta = beta.array() * aDer.array();
+    gradB.noalias() = scale * delta.colwise().sum();
 
-    Eigen::MatrixXd gradW = (1.0 / m) * (nLayerOutputs.transpose() * delta);
+    // dL/dA(l - 1), not needed for the input layer
+    if (i > 1) {
+      beta = &workspace.beta[i - 1];
+      beta->noalias() = delta * cDense->weights.transpose();
 
-    Eigen::MatrixXd gradB = (1.0 / m) * delta.colwise().sum();
-
-    // dL/dA(l - 1)
-    beta = delta * cDense->weights.transpose();
+      // Through a dropout layer, the gradients of the dropped inputs are 0
+      if (nLayer.type == LayerType::DROPOUT) {
+        const Dropout &doLayer = static_cast<const Dropout &>(nLayer);
+        doLayer.applyMask(doLayer.mask, *beta, *beta);
+      }
+    }
 
     // updating weights and biases
+    if (!perLayer) continue;
     this->optimizer->updateWeights(cDense->weights, gradW);
     this->optimizer->updateBiases(cDense->biases, gradB);
   }
+
+  if (!perLayer) this->optimizer->step(stepParameters, pool);
 }
 
-void Network::updateOptimizerSetup(size_t numLayers) {
-  /**
-   * This is a way to let adams know about the number of layers
-   * With that it can setup the `l` variable and the std::vectors
-   *
-   * I'm not very proud of this method but so far it seems like the most
-   * convenient way
-   *
-   * Adam only requires the number of Dense layers
-   */
-
-  size_t nLayers = numLayers;
-
-  if (std::dynamic_pointer_cast<Adam>(this->optimizer)) {
-    // Get the number of dense layers
-    nLayers = std::count_if(
-        this->layers.begin(), this->layers.end(),
-        [](const std::shared_ptr<Layer> &ptr) {
-          return std::dynamic_pointer_cast<Dense>(ptr) != nullptr ||
-                 std::dynamic_pointer_cast<Flatten>(ptr) != nullptr;
-        });
+void Network::dataParallelStep(const Matrix &x, const Matrix &y,
+                               WorkerPool &pool) {
+  const int m = x.rows();
+  const int nWorkers = std::min(pool.size(), m);
+  const size_t nLayers = this->layers.size();
+
+  if (workerSpaces.size() < static_cast<size_t>(nWorkers))
+    initWorkspace(m, pool.size());
+
+  // The dropout masks are drawn for the whole batch (same masks whatever the
+  // number of workers), each worker then uses its rows
+  for (const std::shared_ptr<Layer> &layer : this->layers) {
+    if (layer->type == LayerType::DROPOUT)
+      static_cast<Dropout &>(*layer).drawMask(m, layer->getNumNeurons());
   }
 
-  this->optimizer->insiderInit(nLayers);
+  pool.run([&](int w) {
+    if (w >= nWorkers) return;
+    const int start = w * m / nWorkers;
+    const int n = (w + 1) * m / nWorkers - start;
+    Workspace &ws = workerSpaces[w];
+
+    ws.outputs[0] = x.middleRows(start, n);
+    ws.y = y.middleRows(start, n);
+    for (size_t l = 1; l < nLayers; l++) {
+      if (this->layers[l]->type != LayerType::DROPOUT) continue;
+      const Dropout &doLayer = static_cast<const Dropout &>(*this->layers[l]);
+      ws.masks[l] = doLayer.mask.middleRows(start, n);
+    }
+
+    workerPass(ws);
+  });
+
+  // Reducing the workers' gradients into the arena's, all the gradients
+  // being contiguous, each worker sums a slice of them. The shards are always
+  // added in the same order.
+  const Scalar scale = 1.0 / m;
+  const size_t nParameters = parameters->getSize();
+  auto workerGrads = [&](int v) {
+    return FlatParameterMap(workerSpaces[v].grads.data(), nParameters);
+  };
+
+  pool.run([&](int w) {
+    const size_t start = nParameters * w / pool.size();
+    const size_t n = nParameters * (w + 1) / pool.size() - start;
+    FlatParameterMap grads = parameters->flatGradients();
+
+    grads.segment(start, n) = workerGrads(0).segment(start, n);
+    for (int v = 1; v < nWorkers; v++) {
+      grads.segment(start, n) += workerGrads(v).segment(start, n);
+    }
+    grads.segment(start, n) *= scale;
+  });
+
+  // A single step for all the layers, split across the workers
+  this->optimizer->step(stepParameters, &pool);
+
+  double sumLoss = 0, sumCorrect = 0;
+  for (int w = 0; w < nWorkers; w++) {
+    sumLoss += workerSpaces[w].loss;
+    sumCorrect += workerSpaces[w].accuracy * workerSpaces[w].y.rows();
+  }
+
+  loss = sumLoss / m;
+  accuracy = sumCorrect / m;
+}
+
+void Network::workerPass(Workspace &ws) {
+  const size_t nLayers = this->layers.size();
+  const int n = ws.outputs[0].rows();
+
+  // Forward propagation into the worker's buffers
+  for (size_t l = 1; l < nLayers; l++) {
+    const Layer &cLayer = *this->layers[l];
+
+    if (cLayer.type == LayerType::DROPOUT) {
+      const Dropout &doLayer = static_cast<const Dropout &>(cLayer);
+      ws.outputs[l].resize(n, ws.outputs[l - 1].cols());
+      doLayer.applyMask(ws.masks[l], ws.outputs[l - 1], ws.outputs[l]);
+      continue;
+    }
+
+    assert(cLayer.type == LayerType::DENSE);
+    const Dense &cDense = static_cast<const Dense &>(cLayer);
+    const bool outputLayer = l == nLayers - 1;
+    cDense.forward(ws.outputs[l - 1], ws.outputs[l],
+                   fusedHead && outputLayer ? &ws.logits : nullptr);
+  }
+
+  const Matrix &outputs = ws.outputs[nLayers - 1];
+  ws.loss = fusedHead ? SoftmaxMCE::cmpLoss(ws.logits, ws.y)
+                      : this->cmpLoss(outputs, ws.y);
+  ws.accuracy = computeAccuracy(outputs, ws.y);
+
+  // Backpropagation, same as `backProp` but the gradients are only summed
+  Matrix *beta = &ws.beta[nLayers - 1];
+  if (!fusedHead) this->cmpLossGrad(outputs, ws.y, *beta);
+
+  for (size_t i = nLayers; --i > 0;) {
+    if (this->layers[i]->type != LayerType::DENSE) continue;
+
+    const Dense &cDense = static_cast<const Dense &>(*this->layers[i]);
+    const Matrix &nLayerOutputs = ws.outputs[i - 1];
+
+    Matrix &delta = ws.delta[i];
+
+    if (fusedHead && i == nLayers - 1) {
+      SoftmaxMCE::cmpLossGrad(outputs, ws.y, delta);
+    } else {
+      delta.resize(beta->rows(), beta->cols());
+      cDense.backward(ws.outputs[i], *beta, delta);
+    }
+
+    cDense.weightsGradient(ws.grads.data()).noalias() =
+        nLayerOutputs.transpose() * delta;
+    cDense.biasesGradient(ws.grads.data()).noalias() = delta.colwise().sum();
+
+    if (i > 1) {
+      beta = &ws.beta[i - 1];
+      beta->noalias() = delta * cDense.weights.transpose();
+
+      if (this->layers[i - 1]->type == LayerType::DROPOUT) {
+        const Dropout &doLayer =
+            static_cast<const Dropout &>(*this->layers[i - 1]);
+        doLayer.applyMask(ws.masks[i - 1], *beta, *beta);
+      }
+    }
+  }
+}
+
+void Network::updateOptimizerSetup() {
+  // Lets the optimizer lay out its state like the parameters (ex: Adam's
+  // moments)
+  this->optimizer->insiderInit(*parameters);
 }
 
 void Network::trainingCheckpoint(
-    std::string checkpointName,
-    std::vector<std::shared_ptr<Callback>> callbacks) {
+    const std::string &checkpointName,
+    const std::vector<std::shared_ptr<Callback>> &callbacks) {
   if (callbacks.size() == 0) return;
 
-  for (std::shared_ptr<Callback> callback : callbacks) {
+  for (const std::shared_ptr<Callback> &callback : callbacks) {
     Callback::callMethod(callback, checkpointName, *this);
   }
 }
@@ -412,15 +898,21 @@ void Network::trainingCheckpoint(
  *
  * @return The accuracy of the network.
  */
-double Network::computeAccuracy(Eigen::MatrixXd &outputs, Eigen::MatrixXd &y) {
+double Network::computeAccuracy(const Matrix &outputs, const Matrix &y) {
   int total = y.rows();
 
-  // Hardmax the outputs
-  Eigen::MatrixXd outputsHm = hardmax(outputs);
+  // Sum of |hardmax(outputs) - y|, computed row by row without building the
+  // hardmax matrix
+  double sumDiff = 0;
+  for (int i = 0; i < total; i++) {
+    int maxIndex;
+    outputs.row(i).maxCoeff(&maxIndex);
 
-  Eigen::MatrixXd diff = outputsHm - y;
+    const double yMax = y(i, maxIndex);
+    sumDiff += y.row(i).cwiseAbs().sum() - std::abs(yMax) + std::abs(1 - yMax);
+  }
 
-  int wrong = diff.cwiseAbs().sum() / 2;
+  int wrong = sumDiff / 2;
 
   return 1.0 - (wrong / static_cast<double>(total));
 }
@@ -1,15 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cereal/cereal.hpp>  // for defer
 #include <cereal/types/memory.hpp>
 #include <cereal/types/vector.hpp>
 #include <cstdlib>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
 #include <variant>
 #include <vector>
 
 #include "Model.hpp"
 #include "callbacks/Callback.hpp"
+#include "data/ArrayTrainingData.hpp"
+#include "data/BatchPrefetcher.hpp"
+#include "data/MappedTrainingData.hpp"
 #include "data/TrainingData.hpp"
 #include "layers/Dense.hpp"
 #include "layers/Dropout.hpp"
@@ -18,10 +28,14 @@
 #include "losses/losses.hpp"
 #include "optimizers/Optimizer.hpp"
 #include "optimizers/optimizers.hpp"
+#include "schedulers/schedulers.hpp"
 #include "utils/Formatters.hpp"
 #include "utils/Functions.hpp"
 #include "utils/Gauge.hpp"
+#include "utils/ParameterArena.hpp"
 #include "utils/Variants.hpp"
+#include "utils/WorkerPool.hpp"
+#include "utils/Workspace.hpp"
 
 namespace NeuralNet {
 class Layer;
@@ -36,6 +50,9 @@ class Network : public Model {
    * @param optimizer An Optimizer's child class
    * @param epochs The number of epochs
    * @param loss The loss function
+   *
+   * @throw std::invalid_argument When the HOGWILD training is set and the
+   * optimizer isn't SGD
    */
   void setup(const std::shared_ptr<Optimizer> &optimizer,
              LOSS loss = LOSS::QUADRATIC);
@@ -47,6 +64,66 @@ class Network : public Model {
    */
   void addLayer(std::shared_ptr<Layer> &layer);
 
+  /**
+   * @brief This method will set how the mini-batches are trained on
+   *
+   * With `TRAINING_MODE::DATA_PARALLEL`, every mini-batch is split across
+   * worker threads that each compute the gradients of their share of the
+   * samples. The gradients are then reduced, always in the same order, before
+   * a single optimizer step. The training is thus deterministic for a given
+   * number of threads.
+   *
+   * With `TRAINING_MODE::HOGWILD`, each worker thread trains on whole
+   * mini-batches and updates the shared parameters without locks. It trades
+   * the determinism (and some staleness of the parameters) for scaling, only
+   * the SGD optimizer is supported. The batch callbacks are called by the
+   * workers, one at a time.
+   *
+   * @param mode The training mode
+   * @param nThreads The number of worker threads (0 to use every core)
+   *
+   * @throw std::invalid_argument With `TRAINING_MODE::HOGWILD`, when the
+   * optimizer isn't SGD or the learning rate schedule is per-batch
+   *
+   * @note Only the mini-batch training (batched `TrainingData`) is
+   * parallelized
+   */
+  void setTrainingMode(TRAINING_MODE mode, int nThreads = 0);
+
+  /**
+   * @brief This method will set when the optimizer updates the parameters
+   *
+   * With `UPDATE_SCHEDULE::AFTER_BACKPROP`, the backpropagation computes the
+   * gradients of all the layers first, the optimizer then updates every layer
+   * in a single step, split across the worker threads (see
+   * `setTrainingMode`). It cuts the per-layer overhead of deep and narrow
+   * networks and spreads the update of large ones across the cores. The
+   * parameters are the same as with `UPDATE_SCHEDULE::PER_LAYER`.
+   *
+   * @param schedule The update schedule
+   *
+   * @note The data-parallel training always updates after the
+   * backpropagation, the HOGWILD training always per layer
+   */
+  void setUpdateSchedule(UPDATE_SCHEDULE schedule);
+
+  /**
+   * @brief This method will set the learning rate schedule of the mini-batch
+   * training
+   *
+   * The optimizer's learning rate is set from the schedule at the beginning
+   * of every batch or epoch. The schedule starts over at every training and
+   * the optimizer gets its learning rate back at the end of it. The HOGWILD
+   * workers share the optimizer's rate, so that training only supports the
+   * per-epoch schedules.
+   *
+   * @param scheduler The learning rate schedule (nullptr to remove it)
+   *
+   * @throw std::invalid_argument When a per-batch schedule is set for the
+   * HOGWILD training
+   */
+  void setScheduler(const std::shared_ptr<LRScheduler> &scheduler);
+
   /**
    * @brief This method will set the network's loss function
    *
@@ -137,7 +214,7 @@ class Network : public Model {
    */
   double train(
       TrainingData<std::vector<std::vector<double>>, std::vector<double>>
-          trainingData,
+          &trainingData,
       int epochs = 1,
       const std::vector<std::shared_ptr<Callback>> callbacks = {},
       bool progBar = true);
@@ -155,20 +232,107 @@ class Network : public Model {
    * @return The last training's loss
    */
   double train(TrainingData<std::vector<std::vector<std::vector<double>>>,
-                            std::vector<double>>
-                   trainingData,
+                            std::vector<double>> &trainingData,
                int epochs = 1,
                const std::vector<std::shared_ptr<Callback>> callbacks = {},
                bool progBar = true);
 
+  /**
+   * @brief This method will train the model with the given MappedTrainingData
+   *
+   * @param trainingData the data read from dataset files, it must be batched
+   * @param epochs
+   * @param callbacks A vector of `Callback` that will be called during training
+   * stages
+   * @param progBar Whether to output a progress bar for the training process.
+   * Default: `true`
+   *
+   * @return The last training's loss
+   */
+  double train(MappedTrainingData &trainingData, int epochs = 1,
+               const std::vector<std::shared_ptr<Callback>> callbacks = {},
+               bool progBar = true);
+
+  /**
+   * @brief This method will Train the model with the given inputs and labels,
+   * read from external arrays (ex: NumPy arrays) instead of vectors. The
+   * training is the same as with the vectors of inputs and labels.
+   *
+   * @param inputs A view over the inputs, one sample per row
+   * @param labels A view over the class indexes (one column) or the target
+   * vectors, one per row
+   * @param epochs
+   * @param callbacks A vector of `Callback` that will be called during training
+   * stages
+   * @param progBar Whether to output a progress bar for the training process.
+   * Default: `true`
+   *
+   * @return The last training's loss
+   */
+  double train(const ArrayView &inputs, const ArrayView &labels,
+               int epochs = 1,
+               const std::vector<std::shared_ptr<Callback>> callbacks = {},
+               bool progBar = true);
+
+  /**
+   * @brief This method will train the model with the given ArrayTrainingData
+   *
+   * @param trainingData the data viewing external arrays, it's trained on as a
+   * single batch when it isn't batched
+   * @param epochs
+   * @param callbacks A vector of `Callback` that will be called during training
+   * stages
+   * @param progBar Whether to output a progress bar for the training process.
+   * Default: `true`
+   *
+   * @return The last training's loss
+   */
+  double train(ArrayTrainingData &trainingData, int epochs = 1,
+               const std::vector<std::shared_ptr<Callback>> callbacks = {},
+               bool progBar = true);
+
+  /**
+   * @brief Trains the network on a background thread, with any of the
+   * training data objects `train` takes
+   *
+   * @param trainingData the training data
+   * @param epochs
+   * @param callbacks A vector of `Callback` that will be called during training
+   * stages (from the training thread)
+   * @param progBar Whether to output a progress bar for the training process.
+   * Default: `true`
+   *
+   * @return A future of the last training's loss
+   *
+   * @warning The network and the training data mustn't be used until the
+   * training is over
+   */
+  template <typename Data>
+  std::future<double> trainAsync(
+      Data &trainingData, int epochs = 1,
+      const std::vector<std::shared_ptr<Callback>> callbacks = {},
+      bool progBar = true) {
+    return std::async(std::launch::async, [this, &trainingData, epochs,
+                                           callbacks, progBar] {
+      return this->train(trainingData, epochs, callbacks, progBar);
+    });
+  }
+
   /**
    * @brief This model will try to make predictions based off the inputs passed
    *
-   * @param inputs The inputs that will be passed through the network
+   * @param inputs The inputs that will be passed through the network, one
+   * sample per vector (or one input per vector, the samples as columns)
    *
    * @return This method will return the outputs of the neural network
+   *
+   * @throw std::invalid_argument When the samples size doesn't match the
+   * network's inputs
+   *
+   * @note The network isn't modified (see `InferenceSession`), predictions
+   * can be made from several threads concurrently
    */
-  Eigen::MatrixXd predict(std::vector<std::vector<double>> inputs);
+  Matrix predict(std::vector<std::vector<double>> inputs) const;
 
   /**
    * @brief This model will try to make predictions based off the inputs passed
@@ -176,8 +340,30 @@ class Network : public Model {
    * @param inputs The inputs that will be passed through the network
    *
    * @return This method will return the outputs of the neural network
+   *
+   * @throw std::invalid_argument When the input layer isn't a `Flatten` layer
+   * or the samples shape doesn't match its input shape
+   *
+   * @note The network isn't modified (see `InferenceSession`), predictions
+   * can be made from several threads concurrently
    */
-  Eigen::MatrixXd predict(std::vector<std::vector<std::vector<double>>> inputs);
+  Matrix predict(std::vector<std::vector<std::vector<double>>> inputs) const;
+
+  /**
+   * @brief This model will try to make predictions based off the inputs passed
+   *
+   * @param inputs A view over the inputs (ex: a NumPy array), one sample per
+   * row. Higher dimensional samples are flattened.
+   *
+   * @return This method will return the outputs of the neural network
+   *
+   * @throw std::invalid_argument When the samples size doesn't match the
+   * network's inputs
+   *
+   * @note The network isn't modified (see `InferenceSession`), predictions
+   * can be made from several threads concurrently
+   */
+  Matrix predict(const ArrayView &inputs) const;
 
   /**
    * @brief Save the current model to a binary file
@@ -212,15 +398,26 @@ class Network : public Model {
  private:
   // non-public serialization
   friend class cereal::access;
+  friend class InferenceSession;
 
   std::vector<std::shared_ptr<Layer>> layers;
   LOSS lossFunc =
       LOSS::QUADRATIC;  // Storing the loss function for serialization
   bool progBar = true;
-  double (*cmpLoss)(const Eigen::MatrixXd &, const Eigen::MatrixXd &);
-  Eigen::MatrixXd (*cmpLossGrad)(const Eigen::MatrixXd &,
-                                 const Eigen::MatrixXd &);
+  double (*cmpLoss)(const Matrix &, const Matrix &);
+  void (*cmpLossGrad)(const Matrix &, const Matrix &, Matrix &);
   std::shared_ptr<Optimizer> optimizer;
+  std::shared_ptr<LRScheduler> scheduler;
+  // Parameters of all the layers and their gradients, the layers view it
+  std::shared_ptr<ParameterArena> parameters =
+      std::make_shared<ParameterArena>(0);
+  std::vector<Parameter> stepParameters;  // Views of the arena, for `step`
+  Workspace workspace;  // Backpropagation buffers, reused across batches
+  bool fusedHead = false;  // Softmax output layer with the MCE loss
+  TRAINING_MODE trainingMode = TRAINING_MODE::SEQUENTIAL;
+  UPDATE_SCHEDULE updateSchedule = UPDATE_SCHEDULE::PER_LAYER;
+  int nThreads = 1;
+  std::vector<Workspace> workerSpaces;  // One per data-parallel worker
 
   template <class Archive>
   void save(Archive &archive) const {
@@ -232,17 +429,15 @@ class Network : public Model {
   void load(Archive &archive) {
     archive(cereal::base_class<Model>(this), layers, lossFunc);
     setLoss(lossFunc);
+    packParameters();
   }
 
   /**
    * @brief online training with given training data
    *
-   * @tparam D1 The type of data passed
-   * @tparam D2 The type of labels passed
-   * @param inputs A vector of inputs (features) of type D1
-   * @param labels A vector of labels (targets) of type D2. Each element in this
-   * vector corresponds to the label of the training example at the same index
-   * in the inputs vector.
+   * @param x The inputs (features), one flattened sample per row
+   * @param y The formatted labels (targets), one per row. Each row corresponds
+   * to the label of the training example at the same index in the inputs.
    * @param epochs An integer specifying the number of times the training
    * algorithm should iterate over the dataset.
    * @param callbacks A vector of `Callback` that will be called during training
@@ -254,10 +449,9 @@ class Network : public Model {
    * @note The functions assumes that the inputs and labels will be of the same
    * length.
    */
-  template <typename D1, typename D2>
-  double onlineTraining(std::vector<D1> inputs, std::vector<D2> labels,
-                        int epochs,
-                        std::vector<std::shared_ptr<Callback>> callbacks = {});
+  double onlineTraining(
+      const Matrix &x, const Matrix &y, int epochs,
+      const std::vector<std::shared_ptr<Callback>> &callbacks = {});
 
   /**
    * @brief mini-batch training with given training data
@@ -277,15 +471,15 @@ class Network : public Model {
    * length.
    */
   template <typename D1, typename D2>
-  double trainer(TrainingData<D1, D2> trainingData, int epochs,
-                 std::vector<std::shared_ptr<Callback>> callbacks = {});
+  double trainer(TrainingData<D1, D2> &trainingData, int epochs,
+                 const std::vector<std::shared_ptr<Callback>> &callbacks = {});
 
   /**
    * @brief mini-batch training with given training data
    *
-   * @tparam D1 The type of data passed
-   * @tparam D2 The type of labels passed
-   * @param trainingData A `TrainingData` object
+   * @tparam Data The type of the batched data (`TrainingData`,
+   * `MappedTrainingData` or `ArrayTrainingData`)
+   * @param trainingData A batched data object
    * @param epochs An integer specifying the number of times the training
    * algorithm should iterate over the dataset.
    * @param callbacks A vector of `Callback` that will be called during training
@@ -297,10 +491,34 @@ class Network : public Model {
    * @note The functions assumes that the inputs and labels will be of the same
    * length.
    */
-  template <typename D1, typename D2>
+  template <typename Data>
   double miniBatchTraining(
-      TrainingData<D1, D2> trainingData, int epochs,
-      std::vector<std::shared_ptr<Callback>> callbacks = {});
+      Data &trainingData, int epochs,
+      const std::vector<std::shared_ptr<Callback>> &callbacks = {});
+
+  /**
+   * @brief asynchronous (HOGWILD) mini-batch training with given training
+   * data. Each worker thread pulls the next mini-batch and applies its SGD
+   * update to the shared parameters without any lock, so the other workers
+   * may compute their gradients with slightly stale parameters.
+   *
+   * @tparam Data The type of the batched data (`TrainingData`,
+   * `MappedTrainingData` or `ArrayTrainingData`)
+   * @param trainingData A batched data object
+   * @param epochs An integer specifying the number of times the training
+   * algorithm should iterate over the dataset.
+   * @param callbacks A vector of `Callback` that will be called during training
+   * stages
+   * @return The average loss of the last epoch
+   *
+   * @note Only the SGD optimizer is supported. The batch callbacks are called
+   * by the workers, one at a time, so they see the batches in the order the
+   * workers finish them
+   */
+  template <typename Data>
+  double hogwildTraining(
+      Data &trainingData, int epochs,
+      const std::vector<std::shared_ptr<Callback>> &callbacks = {});
 
   /**
    * @brief batch training with given training data
@@ -319,8 +537,9 @@ class Network : public Model {
    * length.
    */
   template <typename D1, typename D2>
-  double batchTraining(TrainingData<D1, D2> trainingData, int epochs,
-                       std::vector<std::shared_ptr<Callback>> callbacks = {});
+  double batchTraining(
+      TrainingData<D1, D2> &trainingData, int epochs,
+      const std::vector<std::shared_ptr<Callback>> &callbacks = {});
 
   /**
    * @brief This method will pass the inputs through the network and return an
@@ -328,10 +547,11 @@ class Network : public Model {
    *
    * @param inputs The inputs that will be passed through the network
    *
-   * @return The output of the network
+   * @return A reference to the output layer's outputs, valid until the next
+   * forward propagation
    */
-  Eigen::MatrixXd forwardProp(
-      std::vector<std::vector<std::vector<double>>> &inputs,
+  const Matrix &forwardProp(
+      const std::vector<std::vector<std::vector<double>>> &inputs,
       bool training = false);
 
   /**
@@ -340,10 +560,11 @@ class Network : public Model {
    *
    * @param inputs The inputs that will be passed through the network
    *
-   * @return The output of the network
+   * @return A reference to the output layer's outputs, valid until the next
+   * forward propagation
    */
-  Eigen::MatrixXd forwardProp(std::vector<std::vector<double>> &inputs,
-                              bool training = false);
+  const Matrix &forwardProp(const std::vector<std::vector<double>> &inputs,
+                            bool training = false);
 
   /**
    * @brief This method will pass the inputs through the network and return an
@@ -351,12 +572,13 @@ class Network : public Model {
    *
    * @param inputs The inputs that will be passed through the network
    *
-   * @return The output of the network
+   * @return A reference to the output layer's outputs, valid until the next
+   * forward propagation
    */
-  Eigen::MatrixXd forwardProp(Eigen::MatrixXd &inputs, bool training = false);
+  const Matrix &forwardProp(const Matrix &inputs, bool training = false);
 
-  Eigen::MatrixXd feedForward(Eigen::MatrixXd inputs, int startIdx = 0,
-                              bool training = false);
+  const Matrix &feedForward(const Matrix &inputs, int startIdx = 0,
+                            bool training = false);
 
   /**
    * @brief This method will compute the loss and backpropagate it through the
@@ -364,8 +586,56 @@ class Network : public Model {
    *
    * @param outputs The outputs from the forward propagation
    * @param y The expected outputs (targets)
+   * @param pool The workers of the update when it's done after the
+   * backpropagation (nullptr : the calling thread)
+   */
+  void backProp(const Matrix &outputs, const Matrix &y,
+                WorkerPool *pool = nullptr);
+
+  /**
+   * @brief This method will size the backpropagation buffers from the layers
+   * shapes so that the training steps don't allocate any memory. It also
+   * detects a softmax output layer trained with the MCE, in which case the
+   * fused softmax + cross-entropy head is used.
+   *
+   * @param batchSize The number of samples per batch
+   * @param nWorkers The number of data-parallel workers (0 when sequential)
+   * @param wholeBatches Whether each worker trains on whole batches (HOGWILD)
+   * rather than on a shard of every batch
+   */
+  void initWorkspace(int batchSize, int nWorkers = 0,
+                     bool wholeBatches = false);
+
+  /**
+   * @brief This method will train the network on a mini-batch split across
+   * the workers and set the batch's loss and accuracy
+   *
+   * @param x The inputs of the mini-batch
+   * @param y The expected outputs (targets)
+   * @param pool The workers
    */
-  void backProp(Eigen::MatrixXd &outputs, Eigen::MatrixXd &y);
+  void dataParallelStep(const Matrix &x, const Matrix &y, WorkerPool &pool);
+
+  /**
+   * @brief This method will run the forward and backward passes of a worker
+   * on its samples, the gradients (summed over the samples) are written in
+   * the worker's workspace and the parameters aren't updated
+   *
+   * @param ws The worker's workspace, holding the samples (`outputs[0]`),
+   * their expected outputs (`y`) and the dropout masks
+   */
+  void workerPass(Workspace &ws);
+
+  /**
+   * @brief This method will compute the loss of the given outputs (from the
+   * logits when the fused softmax + cross-entropy head is used)
+   *
+   * @param outputs The outputs from the forward propagation
+   * @param y The expected outputs (targets)
+   *
+   * @return The summed loss
+   */
+  double computeLoss(const Matrix &outputs, const Matrix &y);
 
   /**
    * @brief This method will go over the provided callbacks and trigger the
@@ -376,8 +646,9 @@ class Network : public Model {
    * @param callbacks A vector of `Callback` that will be called during training
    * stages
    */
-  void trainingCheckpoint(std::string checkpointName,
-                          std::vector<std::shared_ptr<Callback>> callbacks);
+  void trainingCheckpoint(
+      const std::string &checkpointName,
+      const std::vector<std::shared_ptr<Callback>> &callbacks);
 
   /**
    * @brief This method will compute the accuracy of the model based on the
@@ -388,14 +659,18 @@ class Network : public Model {
    *
    * @return The accuracy of the model (percentage of correct predictions)
    */
-  double computeAccuracy(Eigen::MatrixXd &outputs, Eigen::MatrixXd &y);
+  double computeAccuracy(const Matrix &outputs, const Matrix &y);
+
+  /**
+   * @brief Gathers the parameters of all the layers in a new arena (the
+   * layers keep their values)
+   */
+  void packParameters();
 
   /**
    * @brief This method will update the optimizer's setup
-   *
-   * @param numLayers The number of layers in the network
    */
-  void updateOptimizerSetup(size_t numLayers);
+  void updateOptimizerSetup();
 };
 }  // namespace NeuralNet
 
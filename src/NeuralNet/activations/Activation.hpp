@@ -2,6 +2,8 @@
 
 #include <Eigen/Dense>
 
+#include "utils/Types.hpp"
+
 namespace NeuralNet {
 class Activation {
  public:
@@ -12,7 +14,18 @@ class Activation {
    *
    * @return The activated outputs
    */
-  static Eigen::MatrixXd activate(const Eigen::MatrixXd &z) { return z; };
+  static Matrix activate(const Matrix &z) { return z; };
+
+  /**
+   * @brief Activate a layer's outputs into the given matrix
+   *
+   * @param z A matrix (or block) representing a layer's outputs
+   * @param a The matrix (or block) in which the activated outputs are written,
+   * it must have the shape of `z` and can be `z` itself
+   */
+  static void activate(const ConstMatrixRef &z, MatrixRef a) {
+    if (a.data() != z.data()) a = z;
+  };
 
   /**
    * @brief Compute the derivative of the activation function
@@ -21,7 +34,22 @@ class Activation {
    *
    * @return The activated outputs derivatives
    */
-  static Eigen::MatrixXd diff(const Eigen::MatrixXd &a) { return a; };
+  static Matrix diff(const Matrix &a) { return a; };
+
+  /**
+   * @brief Backpropagate the gradient through the activation function, fusing
+   * the derivative with the upstream gradient (`delta = grad * f'(a)`) without
+   * materializing the derivatives
+   *
+   * @param a Activated outputs
+   * @param grad The gradient of the loss w.r.t the activated outputs
+   * @param delta The matrix in which the gradient of the loss w.r.t the
+   * weighted sums is written, it must have the shape of `a`
+   */
+  static void backward(const ConstMatrixRef &a, const ConstMatrixRef &grad,
+                       MatrixRef delta) {
+    delta.array() = grad.array() * a.array();
+  };
 
   static inline std::string slug = "actv";
 };
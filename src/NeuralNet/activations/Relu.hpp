@@ -5,19 +5,25 @@
 namespace NeuralNet {
 class Relu : public Activation {
  public:
-  static Eigen::MatrixXd activate(const Eigen::MatrixXd &z) {
-    return z.unaryExpr(&Relu::activateValue);
+  // Array expressions (max, comparison masks) are vectorized by Eigen, unlike
+  // a `unaryExpr` through a function pointer
+  static Matrix activate(const Matrix &z) {
+    return z.array().max(static_cast<Scalar>(0));
   }
 
-  static Eigen::MatrixXd diff(const Eigen::MatrixXd &a) {
-    return a.unaryExpr(&Relu::diffValue);
+  static void activate(const ConstMatrixRef &z, MatrixRef a) {
+    a.array() = z.array().max(static_cast<Scalar>(0));
   }
 
-  static inline std::string slug = "rel";
+  static Matrix diff(const Matrix &a) {
+    return (a.array() > 0).cast<Scalar>();
+  }
 
- private:
-  static double diffValue(double a) { return a > 0 ? 1 : 0; }
+  static void backward(const ConstMatrixRef &a, const ConstMatrixRef &grad,
+                       MatrixRef delta) {
+    delta.array() = grad.array() * (a.array() > 0).cast<Scalar>();
+  }
 
-  static double activateValue(double z) { return z < 0 ? 0 : z; }
+  static inline std::string slug = "rel";
 };
 }  // namespace NeuralNet
\ No newline at end of file
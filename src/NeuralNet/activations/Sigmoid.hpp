@@ -5,15 +5,23 @@
 namespace NeuralNet {
 class Sigmoid : public Activation {
  public:
-  static Eigen::MatrixXd activate(const Eigen::MatrixXd &z) {
-    Eigen::MatrixXd negZ = -z;
-    return 1 / (1 + negZ.array().exp());
+  static Matrix activate(const Matrix &z) {
+    return 1 / (1 + (-z.array()).exp());
   };
 
-  static Eigen::MatrixXd diff(const Eigen::MatrixXd &a) {
+  static void activate(const ConstMatrixRef &z, MatrixRef a) {
+    a.array() = 1 / (1 + (-z.array()).exp());
+  };
+
+  static Matrix diff(const Matrix &a) {
     return a.array() * (1.0 - a.array());
   };
 
+  static void backward(const ConstMatrixRef &a, const ConstMatrixRef &grad,
+                       MatrixRef delta) {
+    delta.array() = grad.array() * a.array() * (1 - a.array());
+  };
+
   static inline std::string slug = "sig";
 };
 }  // namespace NeuralNet
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 
 #include "Activation.hpp"
@@ -7,23 +9,97 @@
 namespace NeuralNet {
 class Softmax : public Activation {
  public:
-  static Eigen::MatrixXd activate(const Eigen::MatrixXd &z) {
-    Eigen::MatrixXd exp = z.array().exp();
+  static Matrix activate(const Matrix &z) {
+    Matrix a(z.rows(), z.cols());
+    activate(z, a);
+    return a;
+  };
+
+  /**
+   * @note Numerically stable, each row's maximum is subtracted before the
+   * exponentiation so large logits don't overflow
+   */
+  static void activate(const ConstMatrixRef &z, MatrixRef a) {
+    ChunkArray buffer;
+
+    // The matrices being column-major, the rows are processed by chunks : the
+    // rows reductions are accumulated column by column (contiguous,
+    // vectorized) in a fixed size buffer, so nothing is allocated.
+    for (int r = 0; r < z.rows(); r += chunkRows) {
+      const int n = std::min<int>(chunkRows, z.rows() - r);
+      auto zChunk = z.middleRows(r, n);
+      auto aChunk = a.middleRows(r, n);
+
+      rowsMax(zChunk, buffer);
+
+      // Column by column so that `z` and `a` can be the same matrix
+      for (int c = 0; c < zChunk.cols(); c++) {
+        aChunk.col(c).array() = (zChunk.col(c).array() - buffer.head(n)).exp();
+      }
+
+      buffer.head(n).setZero();
+      for (int c = 0; c < aChunk.cols(); c++) {
+        buffer.head(n) += aChunk.col(c).array();
+      }
 
-    Eigen::MatrixXd sumExp = exp.rowwise().sum().replicate(1, exp.cols());
+      aChunk.array().colwise() /= buffer.head(n);
+    }
+  };
 
-    return exp.array() / sumExp.array();
+  static Matrix diff(const Matrix &a) {
+    return Matrix::Constant(a.rows(), a.cols(), 1);
   };
 
-  static Eigen::MatrixXd diff(const Eigen::MatrixXd &a) {
-    return Eigen::MatrixXd::Constant(a.rows(), a.cols(), 1);
+  /**
+   * @note The softmax jacobian couples the outputs of a row, the product is
+   * `delta = a * (grad - rowsum(a * grad))`. The MCE loss doesn't go through
+   * it, the network fuses it with the softmax (see `SoftmaxMCE`).
+   */
+  static void backward(const ConstMatrixRef &a, const ConstMatrixRef &grad,
+                       MatrixRef delta) {
+    ChunkArray dots;
+
+    for (int r = 0; r < a.rows(); r += chunkRows) {
+      const int n = std::min<int>(chunkRows, a.rows() - r);
+      auto aChunk = a.middleRows(r, n);
+      auto gradChunk = grad.middleRows(r, n);
+      auto deltaChunk = delta.middleRows(r, n);
+
+      dots.head(n).setZero();
+      for (int c = 0; c < aChunk.cols(); c++) {
+        dots.head(n) += aChunk.col(c).array() * gradChunk.col(c).array();
+      }
+
+      // Column by column so that `grad` and `delta` can be the same matrix
+      for (int c = 0; c < aChunk.cols(); c++) {
+        deltaChunk.col(c).array() =
+            aChunk.col(c).array() * (gradChunk.col(c).array() - dots.head(n));
+      }
+    }
   };
 
   static inline std::string slug = "smax";
 
- private:
-  static Eigen::MatrixXd scale(const Eigen::MatrixXd &z, double scaleFactor) {
-    return z * scaleFactor;
+  // Rows processed at once by the row reductions
+  static constexpr int chunkRows = 64;
+  using ChunkArray = Eigen::Array<Scalar, chunkRows, 1>;
+
+  /**
+   * @brief Computes the maximum of each row of a chunk of rows
+   *
+   * @param chunk At most `chunkRows` rows
+   * @param max The array in which the maximums are written (first
+   * `chunk.rows()` values)
+   */
+  template <typename Chunk>
+  static void rowsMax(const Chunk &chunk, ChunkArray &max) {
+    const int n = chunk.rows();
+    assert(n <= chunkRows);
+
+    max.head(n) = chunk.col(0).array();
+    for (int c = 1; c < chunk.cols(); c++) {
+      max.head(n) = max.head(n).max(chunk.col(c).array());
+    }
   }
 };
 }  // namespace NeuralNet
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+#include "ArrayView.hpp"
+#include "MiniBatcher.hpp"
+
+namespace NeuralNet {
+/**
+ * Training data viewing external arrays (ex: NumPy arrays) without copying
+ * them.
+ *
+ * The samples are only read when the mini-batches are gathered, straight from
+ * the viewed memory, which must therefore outlive the training data. The
+ * labels are small and copied.
+ */
+class ArrayTrainingData : public MiniBatcher<float> {
+  friend class Network;
+
+ public:
+  /**
+   * @brief Construct a new Array Training Data object
+   *
+   * @param xTrain The training samples
+   * @param yTrain The training labels, class indexes (1 column, integers in
+   * [0, number of outputs)) or vectors
+   * @param xTest The test samples (optional)
+   * @param yTest The test labels (optional)
+   * @param scale The factor applied to the samples (ex: `1. / 255` to
+   * normalize uint8 pixels)
+   */
+  ArrayTrainingData(const ArrayView &xTrain, const ArrayView &yTrain,
+                    const ArrayView &xTest = ArrayView(),
+                    const ArrayView &yTest = ArrayView(), double scale = 1)
+      : xTrain(xTrain), xTest(xTest), scale(scale) {
+    if (xTrain.rows != yTrain.rows)
+      throw std::invalid_argument(
+          "The inputs and labels must have the same length");
+    if (xTest.rows != yTest.rows)
+      throw std::invalid_argument(
+          "The test inputs and labels must have the same length");
+    if (!xTest.empty() && xTest.cols != xTrain.cols)
+      throw std::invalid_argument(
+          "The test and training samples must have the same size");
+
+    readLabels(yTrain, this->yTrain);
+    readLabels(yTest, this->yTest);
+  }
+
+  /**
+   * @brief Get the number of values in a (flattened) sample
+   */
+  int getSampleSize() const { return xTrain.cols; }
+
+  /**
+   * @brief Gathers the inputs of a mini-batch into the given matrix
+   *
+   * @param b The index of the mini-batch
+   * @param x The matrix in which the inputs will be written (one sample per
+   * row). It's only reallocated when the batch size changes.
+   */
+  void gatherInputs(int b, Matrix &x) const {
+    const int start = batchOffsets[b];
+    const int size = getBatchSize(b);
+
+    x.resize(size, xTrain.cols);
+
+    for (int i = 0; i < size; i++) {
+      xTrain.readRow(indices[start + i], x, i, scale);
+    }
+  }
+
+  /**
+   * @brief Gathers the labels of a mini-batch into the given matrix
+   *
+   * @param b The index of the mini-batch
+   * @param y The matrix in which the formatted labels will be written. It's
+   * only reallocated when the batch size changes.
+   * @param nOutputs The number of outputs of the network
+   */
+  void gatherLabels(int b, Matrix &y, int nOutputs) const {
+    const int start = batchOffsets[b];
+    const int size = getBatchSize(b);
+
+    checkLabels(yTrain, nOutputs);
+    y.resize(size, nOutputs);
+
+    for (int i = 0; i < size; i++) {
+      writeLabel(yTrain, indices[start + i], y, i);
+    }
+  }
+
+  /**
+   * @brief Whether test samples were given
+   */
+  bool hasTestData() const { return !xTest.empty(); }
+
+  /**
+   * @brief Gathers the test inputs and formatted labels
+   *
+   * @param x The matrix in which the test inputs will be written (one sample
+   * per row)
+   * @param y The matrix in which the formatted test labels will be written
+   * @param nOutputs The number of outputs of the network
+   */
+  void gatherTestData(Matrix &x, Matrix &y, int nOutputs) const {
+    xTest.readAll(x, scale);
+    checkLabels(yTest, nOutputs);
+    y.resize(xTest.rows, nOutputs);
+
+    for (int i = 0; i < xTest.rows; i++) writeLabel(yTest, i, y, i);
+  }
+
+ private:
+  using Labels =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  ArrayView xTrain, xTest;
+  Labels yTrain, yTest;  // One label per row
+  int nClasses = 0;  // Largest class index + 1 (class index labels only)
+  double scale;
+
+  int getNumSamples() const override { return xTrain.rows; }
+
+  std::map<float, std::vector<int>> groupByClass() const override {
+    if (yTrain.cols() != 1)
+      throw std::runtime_error(
+          "Stratified batching requires class index labels");
+
+    std::map<float, std::vector<int>> classIndexMap;
+    for (int i = 0; i < yTrain.rows(); i++) {
+      classIndexMap[yTrain(i, 0)].push_back(i);
+    }
+    return classIndexMap;
+  }
+
+  /**
+   * Copies the labels, the class indexes must be non-negative integers
+   */
+  void readLabels(const ArrayView &view, Labels &labels) {
+    Matrix values;
+    view.readAll(values);
+    labels = values.cast<float>();
+
+    if (labels.cols() != 1) return;
+    for (int i = 0; i < labels.rows(); i++) {
+      const float label = labels(i, 0);
+      if (!(label >= 0 && label < std::numeric_limits<int>::max()) ||
+          label != std::floor(label))
+        throw std::invalid_argument(
+            "The class labels must be non-negative integers");
+      nClasses = std::max(nClasses, static_cast<int>(label) + 1);
+    }
+  }
+
+  /**
+   * Checks that the labels fit the network's outputs, before they're
+   * written in the outputs' shape
+   */
+  void checkLabels(const Labels &labels, int nOutputs) const {
+    if (labels.cols() > 1 && labels.cols() != nOutputs)
+      throw std::invalid_argument(
+          "The labels don't match the number of outputs");
+    if (labels.cols() == 1 && nClasses > nOutputs)
+      throw std::invalid_argument(
+          "The class labels exceed the number of outputs");
+  }
+
+  static void writeLabel(const Labels &labels, int index, Matrix &y, int row) {
+    if (labels.cols() > 1) {
+      y.row(row) = labels.row(index).cast<Scalar>();
+    } else {
+      // Setting the cols indexes to 1 (classification tasks)
+      const int colIndex = labels(index, 0);
+      y.row(row).setZero();
+      y(row, colIndex) = 1;
+    }
+  }
+};
+}  // namespace NeuralNet
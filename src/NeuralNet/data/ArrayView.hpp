@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/Enums.hpp"
+#include "utils/Types.hpp"
+
+namespace NeuralNet {
+/**
+ * @brief Get the size in bytes of a value of the given type
+ */
+inline size_t dtypeSize(DTYPE dtype) {
+  switch (dtype) {
+    case DTYPE::UINT8:
+      return sizeof(uint8_t);
+    case DTYPE::FLOAT64:
+      return sizeof(double);
+    default:
+      return sizeof(float);
+  }
+}
+
+/**
+ * @brief Copies contiguous values of the given type into a row of a matrix
+ *
+ * @param values The values
+ * @param dtype The type of the values
+ * @param n The number of values
+ * @param x The destination matrix
+ * @param row The destination row
+ * @param scale The factor applied to the values
+ */
+inline void readValues(const void *values, DTYPE dtype, int n, Matrix &x,
+                       int row, double scale = 1) {
+  using RowVectorXu8 = Eigen::Matrix<uint8_t, 1, Eigen::Dynamic>;
+  const Scalar s = static_cast<Scalar>(scale);
+
+  switch (dtype) {
+    case DTYPE::UINT8:
+      x.row(row) = Eigen::Map<const RowVectorXu8>(
+                       static_cast<const uint8_t *>(values), n)
+                       .cast<Scalar>() *
+                   s;
+      break;
+    case DTYPE::FLOAT64:
+      x.row(row) = Eigen::Map<const Eigen::RowVectorXd>(
+                       static_cast<const double *>(values), n)
+                       .cast<Scalar>() *
+                   s;
+      break;
+    default:
+      x.row(row) = Eigen::Map<const Eigen::RowVectorXf>(
+                       static_cast<const float *>(values), n)
+                       .cast<Scalar>() *
+                   s;
+  }
+}
+
+/**
+ * Non-owning view over a C-contiguous (row-major) array of samples, such as a
+ * NumPy array. Higher dimensional samples are seen flattened : an array of
+ * shape (n, 28, 28) is a view of n rows of 784 values.
+ *
+ * @note The viewed memory must outlive the view
+ */
+struct ArrayView {
+  const void *data = nullptr;
+  DTYPE dtype = DTYPE::FLOAT32;
+  int rows = 0;  // Number of samples
+  int cols = 0;  // Number of values in a (flattened) sample
+
+  ArrayView() = default;
+
+  ArrayView(const void *data, DTYPE dtype, int rows, int cols)
+      : data(data), dtype(dtype), rows(rows), cols(cols){};
+
+  bool empty() const { return rows == 0; }
+
+  /**
+   * @brief Copies a sample into a row of the given matrix
+   *
+   * @param index The index of the sample
+   * @param x The destination matrix
+   * @param row The destination row
+   * @param scale The factor applied to the values
+   */
+  void readRow(int index, Matrix &x, int row, double scale = 1) const {
+    assert(index >= 0 && index < rows);
+    const size_t offset = static_cast<size_t>(index) * cols * dtypeSize(dtype);
+    readValues(static_cast<const uint8_t *>(data) + offset, dtype, cols, x,
+               row, scale);
+  }
+
+  /**
+   * @brief Copies all the samples into the given matrix (one sample per row)
+   */
+  void readAll(Matrix &x, double scale = 1) const {
+    x.resize(rows, cols);
+    for (int i = 0; i < rows; i++) readRow(i, x, i, scale);
+  }
+};
+}  // namespace NeuralNet
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils/Types.hpp"
+
+namespace NeuralNet {
+/**
+ * A mini-batch ready to be fed to the network
+ */
+struct Batch {
+  Matrix x;  // Inputs, one sample per row
+  Matrix y;  // Formatted labels
+};
+
+/**
+ * Producer/consumer stage that prepares the upcoming mini-batches (inputs and
+ * formatted labels) on background threads while the current one is trained
+ * on.
+ *
+ * The batches are handed out in order, so the training is the same with or
+ * without prefetching. Without workers the batches are simply gathered on the
+ * calling thread.
+ *
+ * @tparam Data The batched data type (ex: `TrainingData`), it must provide
+ * `getNumBatches`, `gatherInputs` and `gatherLabels`
+ */
+template <typename Data>
+class BatchPrefetcher {
+ public:
+  /**
+   * @param data The batched data
+   * @param nOutputs The number of outputs of the network (labels format)
+   * @param depth The maximum number of batches prepared ahead
+   * @param nWorkers The number of threads preparing the batches (0 to gather
+   * the batches synchronously)
+   */
+  BatchPrefetcher(const Data &data, int nOutputs, int depth = 2,
+                  int nWorkers = 0)
+      : data(data),
+        nOutputs(nOutputs),
+        depth(nWorkers > 0 ? std::max(depth, 1) : 1),
+        slots(this->depth),
+        ready(this->depth, false),
+        errors(this->depth) {
+    for (int i = 0; i < nWorkers; i++) {
+      workers.emplace_back(&BatchPrefetcher::produce, this);
+    }
+  };
+
+  ~BatchPrefetcher() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stop = true;
+    }
+    cvProduce.notify_all();
+    for (std::thread &worker : workers) worker.join();
+  };
+
+  BatchPrefetcher(const BatchPrefetcher &) = delete;
+  BatchPrefetcher &operator=(const BatchPrefetcher &) = delete;
+
+  /**
+   * @brief Starts preparing the batches of a new epoch.
+   *
+   * @note Every batch of the previous epoch must have been released, the
+   * workers are then idle and the data's batches can safely be modified
+   * beforehand (ex: reshuffled).
+   */
+  void startEpoch() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      nBatches = data.getNumBatches();
+      nextToProduce = 0;
+      nextToConsume = 0;
+    }
+    cvProduce.notify_all();
+  };
+
+  /**
+   * @brief Waits for the next batch of the epoch
+   *
+   * @return The next batch, valid until `release` is called
+   *
+   * @throw The exception thrown while preparing the batch (ex: invalid
+   * labels), on the calling thread
+   */
+  Batch &acquire() {
+    const int b = nextToConsume;
+    const int slot = b % depth;
+    assert(b < nBatches && "No batches left in the current epoch");
+
+    if (workers.empty()) {
+      data.gatherInputs(b, slots[slot].x);
+      data.gatherLabels(b, slots[slot].y, nOutputs);
+      return slots[slot];
+    }
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cvConsume.wait(lock, [this, slot] { return ready[slot]; });
+    if (errors[slot]) {
+      // The batch is lost, the epoch can't go on
+      std::exception_ptr error = nullptr;
+      std::swap(error, errors[slot]);
+      std::rethrow_exception(error);
+    }
+    return slots[slot];
+  };
+
+  /**
+   * @brief Hands the last acquired batch's buffers back to the workers
+   */
+  void release() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      ready[nextToConsume % depth] = false;
+      nextToConsume++;
+    }
+    cvProduce.notify_all();
+  };
+
+ private:
+  const Data &data;
+  int nOutputs;
+  int depth;
+  std::vector<Batch> slots;  // Ring buffer of prepared batches
+  std::vector<bool> ready;
+  std::vector<std::exception_ptr> errors;  // Failures of the slots' batches
+  std::vector<std::thread> workers;
+  std::mutex mtx;
+  std::condition_variable cvProduce, cvConsume;
+  int nBatches = 0, nextToProduce = 0, nextToConsume = 0;
+  bool stop = false;
+
+  /**
+   * Workers loop: claim the next batch as soon as its slot is free, prepare
+   * it outside of the lock and notify the consumer. A failure is handed to the
+   * consumer with the slot, it's rethrown by `acquire`.
+   */
+  void produce() {
+    std::unique_lock<std::mutex> lock(mtx);
+
+    while (true) {
+      cvProduce.wait(lock, [this] {
+        return stop || (nextToProduce < nBatches &&
+                        nextToProduce < nextToConsume + depth);
+      });
+
+      if (stop) return;
+
+      const int b = nextToProduce++;
+      Batch &batch = slots[b % depth];
+
+      std::exception_ptr error = nullptr;
+      lock.unlock();
+      try {
+        data.gatherInputs(b, batch.x);
+        data.gatherLabels(b, batch.y, nOutputs);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      lock.lock();
+
+      errors[b % depth] = error;
+      ready[b % depth] = true;
+      cvConsume.notify_all();
+    }
+  };
+};
+}  // namespace NeuralNet
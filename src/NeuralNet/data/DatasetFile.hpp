@@ -0,0 +1,355 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "ArrayView.hpp"
+#include "utils/Enums.hpp"
+#include "utils/Types.hpp"
+
+#ifdef _WIN32
+#include <memory>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NeuralNet {
+/**
+ * Read-only view over a binary dataset file.
+ *
+ * Layout (native byte order) :
+ *  - a 64 bytes header (see `DatasetFile::Header`)
+ *  - the samples, contiguous and row-major (`rows * cols` values per sample)
+ *    stored as float32, float64 or uint8
+ *  - the labels as float32 (`labelSize` values per sample), starting at the
+ *    next 8 bytes boundary
+ *
+ * A label of size 1 is a class index, larger labels are used as is.
+ *
+ * The file is memory-mapped, so only the pages of the samples that are read
+ * are loaded and the dataset can be larger than the memory.
+ */
+class DatasetFile {
+ public:
+  struct Header {
+    char magic[4] = {'N', 'N', 'D', 'S'};
+    uint32_t version = 1;
+    uint32_t dtype = 0;
+    uint32_t labelSize = 1;
+    uint64_t nSamples = 0;
+    uint32_t rows = 0;
+    uint32_t cols = 0;
+    uint8_t reserved[32] = {};
+  };
+
+  static_assert(sizeof(Header) == 64, "The dataset header must be 64 bytes");
+
+  /**
+   * @brief Maps a dataset file
+   *
+   * @param path The path of the dataset file
+   */
+  DatasetFile(const std::string &path) {
+    map(path);
+
+    bool valid = size >= sizeof(Header);
+    if (valid) {
+      std::memcpy(&header, data, sizeof(Header));
+      valid = std::memcmp(header.magic, "NNDS", 4) == 0 &&
+              header.version == 1 && validLayout(header, size) &&
+              validLabels();
+    }
+
+    if (!valid) {
+      unmap();
+      throw std::runtime_error("Invalid dataset file : " + path);
+    }
+  }
+
+  ~DatasetFile() { unmap(); }
+
+  DatasetFile(const DatasetFile &) = delete;
+  DatasetFile &operator=(const DatasetFile &) = delete;
+
+  /**
+   * @brief Writes a dataset file
+   *
+   * @param path The path of the dataset file
+   * @param inputs The samples (2 or 3 dimensional inputs)
+   * @param labels The labels, class indexes or vectors
+   * @param dtype The type in which the samples are stored
+   *
+   * @note The samples are cast to the stored type, uint8 values are expected
+   * to be in [0, 255]
+   */
+  template <typename X, typename Y>
+  static void write(const std::string &path, const X &inputs, const Y &labels,
+                    DTYPE dtype = DTYPE::FLOAT32) {
+    assert(inputs.size() == labels.size());
+
+    Header header;
+    header.dtype = static_cast<uint32_t>(dtype);
+    header.nSamples = inputs.size();
+
+    if (!inputs.empty()) {
+      if constexpr (std::is_arithmetic<
+                        typename X::value_type::value_type>::value) {
+        header.rows = 1;
+        header.cols = inputs[0].size();
+      } else {
+        header.rows = inputs[0].size();
+        header.cols = inputs[0].empty() ? 0 : inputs[0][0].size();
+      }
+    }
+
+    if constexpr (!std::is_arithmetic<typename Y::value_type>::value) {
+      if (!labels.empty()) header.labelSize = labels[0].size();
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Couldn't create dataset : " + path);
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+
+    for (const auto &sample : inputs) {
+      if constexpr (std::is_arithmetic<
+                        typename X::value_type::value_type>::value) {
+        assert(sample.size() == header.cols);
+        writeValues(file, sample, dtype);
+      } else {
+        assert(sample.size() == header.rows);
+        for (const auto &row : sample) {
+          assert(row.size() == header.cols);
+          writeValues(file, row, dtype);
+        }
+      }
+    }
+
+    // Padding up to the labels
+    const size_t padding = labelsOffset(header) - sizeof(Header) -
+                           header.nSamples * sampleBytes(header);
+    const char zeros[8] = {};
+    file.write(zeros, padding);
+
+    for (const auto &label : labels) {
+      if constexpr (std::is_arithmetic<typename Y::value_type>::value) {
+        const float value = label;
+        file.write(reinterpret_cast<const char *>(&value), sizeof(float));
+      } else {
+        assert(label.size() == header.labelSize);
+        writeValues(file, label, DTYPE::FLOAT32);
+      }
+    }
+  }
+
+  /**
+   * @brief Get the number of samples in the file
+   */
+  int getNumSamples() const { return header.nSamples; }
+
+  /**
+   * @brief Get the number of values in a (flattened) sample
+   */
+  int getSampleSize() const { return header.rows * header.cols; }
+
+  /**
+   * @brief Get the number of values of a label (1 for a class index)
+   */
+  int getLabelSize() const { return header.labelSize; }
+
+  /**
+   * @brief Copies a sample into a row of the given matrix
+   *
+   * @param index The index of the sample
+   * @param x The destination matrix
+   * @param row The destination row
+   * @param scale The factor applied to the stored values
+   */
+  void readSample(int index, Matrix &x, int row, double scale = 1) const {
+    assert(index >= 0 && index < getNumSamples());
+    const uint8_t *sample =
+        samples() + static_cast<size_t>(index) * sampleBytes(header);
+
+    readValues(sample, static_cast<DTYPE>(header.dtype), getSampleSize(), x,
+               row, scale);
+  }
+
+  /**
+   * @brief Writes a sample's formatted label into a row of the given matrix
+   *
+   * @param index The index of the sample
+   * @param y The destination matrix (`nOutputs` columns)
+   * @param row The destination row
+   */
+  void readLabel(int index, Matrix &y, int row) const {
+    assert(index >= 0 && index < getNumSamples());
+    const float *label =
+        labels() + static_cast<size_t>(index) * getLabelSize();
+
+    if (getLabelSize() > 1) {
+      if (getLabelSize() != y.cols())
+        throw std::runtime_error(
+            "The labels don't match the number of outputs");
+      y.row(row) = Eigen::Map<const Eigen::RowVectorXf>(label, getLabelSize())
+                       .cast<Scalar>();
+    } else {
+      // Setting the cols indexes to 1 (classification tasks)
+      const int colIndex = label[0];
+      if (nClasses > y.cols())
+        throw std::runtime_error(
+            "The class labels exceed the number of outputs");
+      y.row(row).setZero();
+      y(row, colIndex) = 1;
+    }
+  }
+
+  /**
+   * @brief Get the class label of a sample (labels of size 1 only)
+   */
+  float classOf(int index) const {
+    assert(getLabelSize() == 1);
+    return labels()[index];
+  }
+
+ private:
+  Header header;
+  const uint8_t *data = nullptr;
+  size_t size = 0;
+  int nClasses = 0;  // Largest class index + 1 (labels of size 1 only)
+#ifdef _WIN32
+  std::unique_ptr<uint8_t[]> buffer;  // No mapping, the file is read
+#endif
+
+  static size_t sampleBytes(const Header &header) {
+    return static_cast<size_t>(header.rows) * header.cols *
+           dtypeSize(static_cast<DTYPE>(header.dtype));
+  }
+
+  static size_t labelsOffset(const Header &header) {
+    const size_t end = sizeof(Header) + header.nSamples * sampleBytes(header);
+    return (end + 7) / 8 * 8;
+  }
+
+  static size_t labelsBytes(const Header &header) {
+    return header.nSamples * header.labelSize * sizeof(float);
+  }
+
+  /**
+   * Whether the header describes samples and labels that fit in a file of the
+   * given size (the sizes are checked against overflows before the offsets
+   * are computed)
+   */
+  static bool validLayout(const Header &header, size_t size) {
+    constexpr uint64_t maxInt = std::numeric_limits<int>::max();
+
+    if (header.dtype > static_cast<uint32_t>(DTYPE::FLOAT64) ||
+        header.labelSize == 0 || header.labelSize > maxInt ||
+        header.nSamples > maxInt ||
+        static_cast<uint64_t>(header.rows) * header.cols > maxInt)
+      return false;
+
+    // The remaining bytes must hold the samples, the padding and the labels
+    const uint64_t available = size - sizeof(Header);
+    const uint64_t sample = sampleBytes(header);
+    const uint64_t label = header.labelSize * sizeof(float);
+    if (header.nSamples == 0) return true;
+    if (sample > available / header.nSamples ||
+        label > available / header.nSamples)
+      return false;
+
+    return size >= labelsOffset(header) &&
+           size - labelsOffset(header) >= labelsBytes(header);
+  }
+
+  /**
+   * Whether the class labels are valid indexes (labels of size 1 only),
+   * records the number of classes
+   */
+  bool validLabels() {
+    if (getLabelSize() != 1) return true;
+
+    const float *values = labels();
+    for (int i = 0; i < getNumSamples(); i++) {
+      const float value = values[i];
+      if (!(value >= 0 && value < std::numeric_limits<int>::max()) ||
+          value != std::floor(value))
+        return false;
+      nClasses = std::max(nClasses, static_cast<int>(value) + 1);
+    }
+    return true;
+  }
+
+  const uint8_t *samples() const { return data + sizeof(Header); }
+
+  const float *labels() const {
+    return reinterpret_cast<const float *>(data + labelsOffset(header));
+  }
+
+  template <typename V>
+  static void writeValues(std::ofstream &file, const V &values, DTYPE dtype) {
+    for (const auto value : values) {
+      if (dtype == DTYPE::UINT8) {
+        const uint8_t v = static_cast<uint8_t>(value);
+        file.write(reinterpret_cast<const char *>(&v), sizeof(uint8_t));
+      } else if (dtype == DTYPE::FLOAT64) {
+        const double v = static_cast<double>(value);
+        file.write(reinterpret_cast<const char *>(&v), sizeof(double));
+      } else {
+        const float v = static_cast<float>(value);
+        file.write(reinterpret_cast<const char *>(&v), sizeof(float));
+      }
+    }
+  }
+
+#ifdef _WIN32
+  void map(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error("Couldn't open dataset : " + path);
+    size = file.tellg();
+    buffer = std::make_unique<uint8_t[]>(size);
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(buffer.get()), size);
+    data = buffer.get();
+  }
+
+  void unmap() {}
+#else
+  void map(const std::string &path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Couldn't open dataset : " + path);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+      close(fd);
+      throw std::runtime_error("Invalid dataset file : " + path);
+    }
+
+    size = st.st_size;
+    void *addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  // The mapping keeps the file open
+
+    if (addr == MAP_FAILED)
+      throw std::runtime_error("Couldn't map dataset : " + path);
+
+    data = static_cast<const uint8_t *>(addr);
+  }
+
+  void unmap() {
+    if (data) munmap(const_cast<uint8_t *>(data), size);
+  }
+#endif
+};
+}  // namespace NeuralNet
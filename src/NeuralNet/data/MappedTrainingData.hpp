@@ -0,0 +1,133 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "DatasetFile.hpp"
+#include "MiniBatcher.hpp"
+
+namespace NeuralNet {
+/**
+ * Training data read straight out of dataset files (see `DatasetFile`).
+ *
+ * The files are memory-mapped and the mini-batches are gathered from them
+ * on demand, the samples are never loaded all at once. This allows training
+ * on datasets larger than the memory without any conversion.
+ */
+class MappedTrainingData : public MiniBatcher<float> {
+  friend class Network;
+
+ public:
+  /**
+   * @brief Construct a new Mapped Training Data object
+   *
+   * @param trainPath The path of the training dataset file
+   * @param testPath The path of the test dataset file (optional)
+   * @param scale The factor applied to the stored samples (ex: `1. / 255` to
+   * normalize uint8 pixels)
+   *
+   * @throw std::runtime_error When a file is invalid, or the test samples
+   * don't have the size of the training samples
+   */
+  MappedTrainingData(const std::string &trainPath,
+                     const std::string &testPath = "", double scale = 1)
+      : train(std::make_shared<DatasetFile>(trainPath)), scale(scale) {
+    if (!testPath.empty()) {
+      test = std::make_shared<DatasetFile>(testPath);
+      if (test->getSampleSize() != train->getSampleSize())
+        throw std::runtime_error(
+            "The test samples size doesn't match the training's : " +
+            testPath);
+    }
+  }
+
+  /**
+   * @brief Get the number of values in a (flattened) sample
+   */
+  int getSampleSize() const { return train->getSampleSize(); }
+
+  /**
+   * @brief Gathers the inputs of a mini-batch into the given matrix
+   *
+   * @param b The index of the mini-batch
+   * @param x The matrix in which the inputs will be written (one sample per
+   * row). It's only reallocated when the batch size changes.
+   */
+  void gatherInputs(int b, Matrix &x) const {
+    const int start = batchOffsets[b];
+    const int size = getBatchSize(b);
+
+    x.resize(size, train->getSampleSize());
+
+    for (int i = 0; i < size; i++) {
+      train->readSample(indices[start + i], x, i, scale);
+    }
+  }
+
+  /**
+   * @brief Gathers the labels of a mini-batch into the given matrix
+   *
+   * @param b The index of the mini-batch
+   * @param y The matrix in which the formatted labels will be written. It's
+   * only reallocated when the batch size changes.
+   * @param nOutputs The number of outputs of the network
+   */
+  void gatherLabels(int b, Matrix &y, int nOutputs) const {
+    const int start = batchOffsets[b];
+    const int size = getBatchSize(b);
+
+    y.resize(size, nOutputs);
+
+    for (int i = 0; i < size; i++) {
+      train->readLabel(indices[start + i], y, i);
+    }
+  }
+
+  /**
+   * @brief Whether a test dataset was given
+   */
+  bool hasTestData() const { return test && test->getNumSamples() > 0; }
+
+  /**
+   * @brief Gathers the test inputs and formatted labels
+   *
+   * @param x The matrix in which the test inputs will be written (one sample
+   * per row)
+   * @param y The matrix in which the formatted test labels will be written
+   * @param nOutputs The number of outputs of the network
+   */
+  void gatherTestData(Matrix &x, Matrix &y, int nOutputs) const {
+    const int n = test->getNumSamples();
+
+    x.resize(n, test->getSampleSize());
+    y.resize(n, nOutputs);
+
+    for (int i = 0; i < n; i++) {
+      test->readSample(i, x, i, scale);
+      test->readLabel(i, y, i);
+    }
+  }
+
+ private:
+  std::shared_ptr<DatasetFile> train, test;
+  double scale;
+
+  int getNumSamples() const override { return train->getNumSamples(); }
+
+  std::map<float, std::vector<int>> groupByClass() const override {
+    if (train->getLabelSize() != 1)
+      throw std::runtime_error(
+          "Stratified batching requires class index labels");
+
+    std::map<float, std::vector<int>> classIndexMap;
+    for (int i = 0; i < train->getNumSamples(); i++) {
+      classIndexMap[train->classOf(i)].push_back(i);
+    }
+    return classIndexMap;
+  }
+};
+}  // namespace NeuralNet
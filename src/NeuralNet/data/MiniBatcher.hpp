@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace NeuralNet {
+/**
+ * Base class of the batched data sources (`TrainingData`,
+ * `MappedTrainingData`).
+ *
+ * Mini-batches are only represented by indexes into the samples, the samples
+ * themselves are never moved. Each data source provides its number of samples
+ * and the samples grouped by class (for stratified batching) and is in charge
+ * of gathering the indexed samples.
+ *
+ * @tparam Label The type of a sample's label
+ */
+template <typename Label>
+class MiniBatcher {
+  friend class Network;
+
+ public:
+  virtual ~MiniBatcher() = default;
+
+  /**
+   * @brief This method will separate the inputs and labels data into batches of
+   * the specified size
+   *
+   * @param batchSize The number of elements in each batch
+   * @param stratified Whether each batch should keep the classes proportions
+   * @param shuffle Whether to shuffle the samples before batching them
+   * @param dropLast Whether to drop the last batch if it's incomplete
+   * @param verbose Whether to print information about the batching
+   * @param reshuffle Whether to draw new batches at the beginning of each epoch
+   * @param seed The seed used to shuffle the samples (0 for a random seed)
+   */
+  void batch(int batchSize, bool stratified = false, bool shuffle = false,
+             bool dropLast = false, bool verbose = false,
+             bool reshuffle = false, unsigned int seed = 0) {
+    batched = true;
+    this->batchSize = batchSize;
+    this->stratified = stratified;
+    this->shuffleBatches = shuffle;
+    this->dropLast = dropLast;
+    this->reshuffle = reshuffle;
+    rng.seed(seed != 0 ? seed : std::random_device()());
+    if (!stratified)
+      return normalMiniBatch(batchSize, shuffle, dropLast, verbose);
+    return stratifiedMiniBatch(batchSize, shuffle, dropLast, verbose);
+  };
+
+  /**
+   * @brief Prepares the batches for the next epoch.
+   *
+   * When the data was batched with `reshuffle`, the samples order is permuted
+   * so that each epoch sees new batches. Only the indexes are shuffled, the
+   * samples themselves are never moved.
+   */
+  void nextEpoch() {
+    if (!batched || !reshuffle) return;
+    if (!stratified) return shuffle(indices.begin(), indices.end());
+    return stratifiedMiniBatch(batchSize, shuffleBatches, dropLast, false,
+                               true);
+  }
+
+  /**
+   * @brief Prepares the upcoming mini-batches on background threads while the
+   * network trains on the current one.
+   *
+   * @param depth The maximum number of batches prepared ahead
+   * @param nWorkers The number of threads preparing the batches (0 disables
+   * prefetching)
+   */
+  void prefetch(int depth = 2, int nWorkers = 1) {
+    assert(depth > 0 && nWorkers >= 0);
+    prefetchDepth = depth;
+    prefetchWorkers = nWorkers;
+  }
+
+  /**
+   * @brief Get the number of mini-batches
+   *
+   * @return The number of mini-batches (0 if the data is not batched)
+   */
+  int getNumBatches() const {
+    return batchOffsets.empty() ? 0 : batchOffsets.size() - 1;
+  }
+
+  /**
+   * @brief Get the number of samples in a given mini-batch
+   *
+   * @param b The index of the mini-batch
+   *
+   * @return The mini-batch's size
+   */
+  int getBatchSize(int b) const {
+    assert(b >= 0 && b < getNumBatches());
+    return batchOffsets[b + 1] - batchOffsets[b];
+  }
+
+ protected:
+  std::vector<int> indices;  // Order in which the samples are batched
+  std::vector<int> batchOffsets;  // Batch b is [offsets[b], offsets[b + 1])
+  std::mt19937 rng;
+  int batchSize = 0, prefetchDepth = 1, prefetchWorkers = 0;
+  bool batched = false, stratified = false, shuffleBatches = false,
+       dropLast = false, reshuffle = false;
+
+  /**
+   * @brief Get the number of training samples
+   */
+  virtual int getNumSamples() const = 0;
+
+  /**
+   * @brief Groups the training samples indexes by class
+   */
+  virtual std::map<Label, std::vector<int>> groupByClass() const = 0;
+
+  void printDropLast(const size_t size, const size_t requiredSize) {
+    std::cout << "Dropping last mini-batch (size : " << size << " < "
+              << requiredSize << ")" << std::endl;
+  };
+
+  void printNBatchesCreated(const size_t nBatches) {
+    std::cout << "Total mini-batches created : " << nBatches << std::endl;
+  }
+
+  void shuffle(std::vector<int>::iterator begin,
+               std::vector<int>::iterator end) {
+    std::shuffle(begin, end, rng);
+  };
+
+  void normalMiniBatch(int batchSize, bool shuffle = false,
+                       bool dropLast = false, bool verbose = false) {
+    const int nInputs = getNumSamples();
+    assert(nInputs > 0 && batchSize <= nInputs);
+
+    indices.resize(nInputs);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    if (shuffle) this->shuffle(indices.begin(), indices.end());
+
+    batchOffsets.clear();
+    batchOffsets.reserve((nInputs + batchSize - 1) / batchSize + 1);
+
+    int batchedEnd = 0;
+    for (int startIdx = 0; startIdx < nInputs; startIdx += batchSize) {
+      const int endIdx = std::min(startIdx + batchSize, nInputs);
+
+      if (endIdx - startIdx < batchSize && dropLast) {
+        if (verbose)
+          printDropLast(endIdx - startIdx, static_cast<size_t>(batchSize));
+        break;
+      }
+
+      batchOffsets.push_back(startIdx);
+      batchedEnd = endIdx;
+    }
+
+    // Dropped samples stay at the end of `indices` so that they can be picked
+    // again when reshuffling
+    batchOffsets.push_back(batchedEnd);
+
+    if (verbose) printNBatchesCreated(getNumBatches());
+  };
+
+  void stratifiedMiniBatch(int batchSize, bool shuffle = false,
+                           bool dropLast = false, bool verbose = false,
+                           bool shuffleClasses = false) {
+    // Group sample indexes by class
+    std::map<Label, std::vector<int>> classIndexMap = groupByClass();
+
+    if (shuffleClasses) {
+      for (auto &classPair : classIndexMap) {
+        this->shuffle(classPair.second.begin(), classPair.second.end());
+      }
+    }
+
+    // Calculate number of samples per class in each batch
+    std::map<Label, int> classBatchSize;
+    int totalSamples = getNumSamples();
+    for (const auto &classPair : classIndexMap) {
+      int classCount = classPair.second.size();
+      classBatchSize[classPair.first] = (classCount * batchSize) / totalSamples;
+
+      if (verbose)
+        std::cout << "Class count for (" << classPair.first
+                  << ") = " << classCount
+                  << " - classBatchSize = " << classBatchSize[classPair.first]
+                  << std::endl;
+    }
+
+    indices.clear();
+    indices.reserve(totalSamples);
+    batchOffsets.assign(1, 0);
+
+    // Create batches
+    bool moreData = true;
+    while (moreData) {
+      const size_t batchStart = indices.size();
+      moreData = false;
+
+      // Fill mini-batch with value of each class
+      for (auto &classPair : classIndexMap) {
+        std::vector<int> &classIndexes = classPair.second;
+        int nSamplesToAdd = classBatchSize[classPair.first];
+
+        for (int i = 0; i < nSamplesToAdd && !classIndexes.empty(); i++) {
+          indices.push_back(classIndexes.back());
+          classIndexes.pop_back();
+        }
+
+        if (!classIndexes.empty()) {
+          moreData = true;
+        }
+      }
+
+      while (indices.size() - batchStart < static_cast<size_t>(batchSize) &&
+             moreData) {
+        bool added = false;
+        for (auto &classPair : classIndexMap) {
+          if (!classPair.second.empty()) {
+            indices.push_back(classPair.second.back());
+            classPair.second.pop_back();
+            added = true;
+            if (indices.size() - batchStart == static_cast<size_t>(batchSize))
+              break;
+          }
+        }
+
+        if (!added) break;
+      }
+
+      const size_t size = indices.size() - batchStart;
+
+      if (size < static_cast<size_t>(batchSize) && dropLast) {
+        // skip placing it in the batches
+        if (verbose) printDropLast(size, static_cast<size_t>(batchSize));
+        indices.resize(batchStart);
+        continue;
+      }
+
+      if (size > 0) {
+        // Shuffle batches if indicated
+        if (shuffle) this->shuffle(indices.begin() + batchStart, indices.end());
+        batchOffsets.push_back(indices.size());
+      }
+    }
+
+    if (verbose) printNBatchesCreated(getNumBatches());
+  }
+};
+}  // namespace NeuralNet
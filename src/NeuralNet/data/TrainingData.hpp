@@ -1,205 +1,237 @@
 #pragma once
 
-#include <algorithm>
-#include <random>
+#include <Eigen/Dense>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <utility>  // For std::pair
 #include <vector>
 
+#include "MiniBatcher.hpp"
+#include "utils/Types.hpp"
+
 namespace NeuralNet {
 template <typename X, typename Y>
-class TrainingData {
+class TrainingData : public MiniBatcher<typename Y::value_type> {
   friend class Network;
 
+  using Base = MiniBatcher<typename Y::value_type>;
+  using Base::batchOffsets;
+  using Base::indices;
+
  public:
+  using Base::getBatchSize;
+  using Base::getNumBatches;
+
   /**
    * @brief Construct a new Training Data object.
    * This object is used to store the inputs and labels data,
    * it comes with a set of methods to manipulate the data to your liking for
    * better training optimization.
    *
+   * The inputs are stored once in a contiguous buffer (one flattened sample
+   * per row), mini-batches are then only represented by indexes into it.
+   *
    * @param inputs_data The inputs data
    * @param labels_data The labels data
    *
    * @note The inputs and labels data must have the same size
    */
   TrainingData(X xTrain, Y yTrain, X xTest = X(), Y yTest = Y())
-      : xTrain(xTrain), yTrain(yTrain), xTest(xTest), yTest(yTest) {
+      : yTrain(yTrain), yTest(yTest) {
     assert(xTrain.size() == yTrain.size());
-    if (!xTest.empty() && !yTest.empty()) assert(xTest.size() == xTest.size());
+    if (!xTest.empty() && !yTest.empty()) assert(xTest.size() == yTest.size());
+    if (!xTrain.empty()) sampleShape = shapeOf(xTrain[0]);
+    this->xTrain = toContiguous<RowMatrix>(xTrain);
+    this->xTest = toContiguous<Matrix>(xTest);
   }
 
-  std::vector<std::pair<X, Y>> getMiniBatches() { return this->miniBatches; }
-
   /**
-   * @brief This method will separate the inputs and labels data into batches of
-   * the specified size
+   * @brief Builds the mini-batches out of the stored batch indexes.
+   *
+   * @return The mini-batches as pairs of inputs and labels
    *
-   * @param batchSize The number of elements in each batch
+   * @note The returned batches are copies of the data, the training itself
+   * doesn't rely on this method.
    */
-  void batch(int batchSize, bool stratified = false, bool shuffle = false,
-             bool dropLast = false, bool verbose = false) {
-    batched = true;
-    if (!stratified)
-      return normalMiniBatch(batchSize, xTrain, yTrain, shuffle, dropLast,
-                             verbose);
-    return stratifiedMiniBatch(batchSize, xTrain, yTrain, shuffle, dropLast,
-                               verbose);
-  };
-
- private:
-  X xTrain;
-  Y yTrain;
-  X xTest;
-  Y yTest;
-  std::vector<std::pair<X, Y>> miniBatches;
-  bool batched = false;
-
-  void printDropLast(const size_t size, const size_t requiredSize) {
-    std::cout << "Dropping last mini-batch (size : " << size << " < "
-              << requiredSize << ")" << std::endl;
-  };
-
-  void printNBatchesCreated(const size_t nBatches) {
-    std::cout << "Total mini-batches created : " << nBatches << std::endl;
-  }
-
-  template <typename Ti, typename Tl>
-  void shuffle(std::vector<Ti>& inputs, std::vector<Tl>& labels) {
-    // Create a vector of pairs (data, label)
-    std::vector<std::pair<Ti, Tl>> combined;
-    for (size_t i = 0; i < inputs.size(); ++i) {
-      combined.emplace_back(inputs[i], labels[i]);
+  std::vector<std::pair<X, Y>> getMiniBatches() const {
+    std::vector<std::pair<X, Y>> miniBatches;
+    miniBatches.reserve(getNumBatches());
+
+    for (int b = 0; b < getNumBatches(); b++) {
+      X xMiniBatch;
+      Y yMiniBatch;
+      for (int i = batchOffsets[b]; i < batchOffsets[b + 1]; i++) {
+        xMiniBatch.push_back(sampleAt(indices[i]));
+        yMiniBatch.push_back(yTrain[indices[i]]);
+      }
+      miniBatches.emplace_back(xMiniBatch, yMiniBatch);
     }
 
-    // Create a random number generator
-    std::random_device rd;
-    std::mt19937 g(rd());
-
-    // Shuffle the combined vector
-    std::shuffle(combined.begin(), combined.end(), g);
+    return miniBatches;
+  }
 
-    // Separate the shuffled data and labels
-    for (size_t i = 0; i < combined.size(); ++i) {
-      inputs[i] = combined[i].first;
-      labels[i] = combined[i].second;
-    }
-  };
+  /**
+   * @brief Gathers the inputs of a mini-batch into the given matrix
+   *
+   * @param b The index of the mini-batch
+   * @param x The matrix in which the inputs will be written (one sample per
+   * row). It's only reallocated when the batch size changes.
+   */
+  void gatherInputs(int b, Matrix &x) const {
+    const int start = batchOffsets[b];
+    const int size = getBatchSize(b);
 
-  void normalMiniBatch(int batchSize, X& x, Y& y, bool shuffle = false,
-                       bool dropLast = false, bool verbose = false) {
-    int nInputs = x.size();
-    assert(nInputs > 0 && batchSize < nInputs);
-    int nMiniBatches = (nInputs + batchSize - 1) / batchSize;
+    x.resize(size, xTrain.cols());
 
-    if (shuffle) {
-      this->shuffle(x, y);
+    for (int i = 0; i < size; i++) {
+      x.row(i) = xTrain.row(indices[start + i]);
     }
+  }
 
-    miniBatches.reserve(nMiniBatches);
+  /**
+   * @brief Gathers the labels of a mini-batch into the given matrix
+   *
+   * @param b The index of the mini-batch
+   * @param y The matrix in which the formatted labels will be written. It's
+   * only reallocated when the batch size changes.
+   * @param nOutputs The number of outputs of the network
+   *
+   * @note The labels are formatted the same way `formatLabels` does it
+   */
+  void gatherLabels(int b, Matrix &y, int nOutputs) const {
+    const int start = batchOffsets[b];
+    const int size = getBatchSize(b);
 
-    for (int i = 0; i < nMiniBatches; ++i) {
-      int startIdx = i * batchSize;
-      int endIdx = std::min((i + 1) * batchSize, static_cast<int>(nInputs));
+    y.resize(size, nOutputs);
 
-      X xMiniBatch(x.begin() + startIdx, x.begin() + endIdx);
-      Y yMiniBatch(y.begin() + startIdx, y.begin() + endIdx);
+    for (int i = 0; i < size; i++) {
+      writeLabel(yTrain[indices[start + i]], y, i);
+    }
+  }
 
-      std::pair<X, Y> miniBatch = std::make_pair(xMiniBatch, yMiniBatch);
+  /**
+   * @brief Whether test inputs and labels were given
+   */
+  bool hasTestData() const { return xTest.rows() > 0 && !yTest.empty(); }
 
-      if (xMiniBatch.size() < static_cast<size_t>(batchSize) && dropLast) {
-        if (verbose)
-          printDropLast(xMiniBatch.size(), static_cast<size_t>(batchSize));
-        continue;
-      }
+  /**
+   * @brief Gathers the test inputs and formatted labels
+   *
+   * @param x The matrix in which the test inputs will be written (one sample
+   * per row)
+   * @param y The matrix in which the formatted test labels will be written
+   * @param nOutputs The number of outputs of the network
+   */
+  void gatherTestData(Matrix &x, Matrix &y, int nOutputs) const {
+    x = xTest;
+    y.resize(yTest.size(), nOutputs);
 
-      miniBatches.push_back(miniBatch);
+    for (size_t i = 0; i < yTest.size(); i++) {
+      writeLabel(yTest[i], y, i);
     }
+  }
 
-    // empty the respective containers
-    x.erase(x.begin(), x.end());
-    y.erase(y.begin(), y.end());
+ private:
+  RowMatrix xTrain;  // One flattened sample per row
+  Y yTrain;
+  Matrix xTest;
+  Y yTest;
+  std::tuple<int, int> sampleShape = {0, 0};
 
-    if (verbose) printNBatchesCreated(miniBatches.size());
-  };
+  int getNumSamples() const override { return xTrain.rows(); }
 
-  template <typename Tx, typename Ty>
-  void stratifiedMiniBatch(int batchSize, std::vector<Tx>& x,
-                           std::vector<Ty>& y, bool shuffle = false,
-                           bool dropLast = false, bool verbose = false) {
-    // Group data by class
-    std::map<Ty, X> classDataMap;
-    for (size_t i = 0; i < x.size(); i++) {
-      classDataMap[y[i]].push_back(x[i]);
+  std::map<typename Y::value_type, std::vector<int>> groupByClass()
+      const override {
+    std::map<typename Y::value_type, std::vector<int>> classIndexMap;
+    for (size_t i = 0; i < yTrain.size(); i++) {
+      classIndexMap[yTrain[i]].push_back(i);
     }
+    return classIndexMap;
+  }
 
-    // Calculate number of samples per class in each batch
-    std::map<Ty, int> classBatchSize;
-    int totalSamples = x.size();
-    for (const auto& classPair : classDataMap) {
-      int classCount = classPair.second.size();
-      classBatchSize[classPair.first] = (classCount * batchSize) / totalSamples;
-
-      if (verbose)
-        std::cout << "Class count for (" << classPair.first
-                  << ") = " << classCount
-                  << " - classBatchSize = " << classBatchSize[classPair.first]
-                  << std::endl;
+  template <typename T>
+  static std::tuple<int, int> shapeOf(const std::vector<T> &sample) {
+    if constexpr (std::is_arithmetic<T>::value) {
+      return {1, static_cast<int>(sample.size())};
+    } else {
+      return {static_cast<int>(sample.size()),
+              sample.empty() ? 0 : static_cast<int>(sample[0].size())};
     }
+  }
 
-    // Create batches
-    bool moreData = true;
-    while (moreData) {
-      X batchData;
-      Y batchLabels;
-      moreData = false;
-
-      // Fill mini-batch with value of each class
-      for (auto& classPair : classDataMap) {
-        Ty classLabel = classPair.first;
-        X& classSamples = classPair.second;
-        int nSamplesToAdd = classBatchSize[classLabel];
-
-        for (int i = 0; i < nSamplesToAdd && !classSamples.empty(); i++) {
-          batchData.push_back(classSamples.back());
-          batchLabels.push_back(classLabel);
-          classSamples.pop_back();
-        }
+  /**
+   * @brief Copies the (flattened) samples into a contiguous matrix, one sample
+   * per row.
+   */
+  template <typename M>
+  static M toContiguous(const X &x) {
+    if (x.empty()) return M(0, 0);
 
-        if (!classSamples.empty()) {
-          moreData = true;
-        }
-      }
+    const auto [rows, cols] = shapeOf(x[0]);
+    M m(x.size(), rows * cols);
 
-      while (batchData.size() < static_cast<size_t>(batchSize) && moreData) {
-        bool added = false;
-        for (auto& classPair : classDataMap) {
-          if (!classPair.second.empty()) {
-            batchData.push_back(classPair.second.back());
-            batchLabels.push_back(classPair.first);
-            classPair.second.pop_back();
-            added = true;
-            if (batchData.size() == static_cast<size_t>(batchSize)) break;
-          }
+    for (size_t i = 0; i < x.size(); i++) {
+      if constexpr (std::is_arithmetic<typename X::value_type::value_type>::
+                        value) {
+        assert(x[i].size() == static_cast<size_t>(cols));
+        for (int c = 0; c < cols; c++) m(i, c) = x[i][c];
+      } else {
+        assert(x[i].size() == static_cast<size_t>(rows));
+        for (int r = 0; r < rows; r++) {
+          assert(x[i][r].size() == static_cast<size_t>(cols));
+          for (int c = 0; c < cols; c++) m(i, r * cols + c) = x[i][r][c];
         }
-
-        if (!added) break;
       }
+    }
 
-      if (batchData.size() < static_cast<size_t>(batchSize) && dropLast) {
-        // skip placing it in miniBatches
-        if (verbose)
-          printDropLast(batchData.size(), static_cast<size_t>(batchSize));
-        continue;
-      }
+    return m;
+  }
 
-      if (!batchData.empty()) {
-        // Shuffle batches if indicated
-        if (shuffle) this->shuffle(batchData, batchLabels);
-        miniBatches.emplace_back(batchData, batchLabels);
+  /**
+   * @brief Rebuilds the original sample at the given index
+   */
+  typename X::value_type sampleAt(int index) const {
+    const Scalar *data = xTrain.row(index).data();
+    const auto [rows, cols] = sampleShape;
+
+    if constexpr (std::is_arithmetic<typename X::value_type::value_type>::
+                      value) {
+      return typename X::value_type(data, data + cols);
+    } else {
+      typename X::value_type sample;
+      sample.reserve(rows);
+      for (int r = 0; r < rows; r++) {
+        sample.emplace_back(data + r * cols, data + (r + 1) * cols);
       }
+      return sample;
     }
+  }
 
-    if (verbose) printNBatchesCreated(miniBatches.size());
+  /**
+   * @brief Writes a label in the outputs' shape, after checking that it fits
+   * the network's outputs
+   */
+  template <typename T>
+  static void writeLabel(const T &label, Matrix &y, int row) {
+    if constexpr (std::is_same<T, std::vector<double>>::value) {
+      if (label.size() != static_cast<size_t>(y.cols()))
+        throw std::invalid_argument(
+            "The labels don't match the number of outputs");
+      for (int c = 0; c < y.cols(); c++) y(row, c) = label[c];
+    } else {
+      if (!(label >= 0))
+        throw std::invalid_argument(
+            "The class labels must be non-negative integers");
+      if (!(label < y.cols()))
+        throw std::invalid_argument(
+            "The class labels exceed the number of outputs");
+      // Setting the cols indexes to 1 (classification tasks)
+      const int colIndex = label;
+      y.row(row).setZero();
+      y(row, colIndex) = 1;
+    }
   }
 };
-}  // namespace NeuralNet
\ No newline at end of file
+}  // namespace NeuralNet
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <cereal/access.hpp>
 #include <cereal/cereal.hpp>
 #include <cereal/types/base_class.hpp>
 #include <cereal/types/polymorphic.hpp>
+#include <memory>
+#include <new>
 
 #include "Layer.hpp"
+#include "utils/ParameterArena.hpp"
+#include "utils/Random.hpp"
 
 namespace NeuralNet {
 class Dense : public Layer {
@@ -23,23 +28,23 @@ class Dense : public Layer {
   /**
    * @brief This method gets the layer's weights
    *
-   * @return an Eigen::MatrixXd  representing the weights
+   * @return a view of the weights
    */
-  Eigen::MatrixXd getWeights() const { return weights; };
+  ConstMatrixRef getWeights() const { return weights; };
 
   /**
    * @brief Return the biases of the layer
    *
-   * @return an Eigen::Matrix representing the biases
+   * @return a view of the biases
    */
-  Eigen::MatrixXd getBiases() const { return biases; };
+  ConstMatrixRef getBiases() const { return biases; };
 
   /**
    * @brief This method get the layer's outputs
    *
-   * @return an Eigen::Eigen::MatrixXd  representing the layer's outputs
+   * @return a Matrix  representing the layer's outputs
    */
-  Eigen::MatrixXd getOutputs() const { return outputs; };
+  const Matrix &getOutputs() const { return outputs; };
 
   /**
    * @brief Method to print layer's weights
@@ -59,25 +64,27 @@ class Dense : public Layer {
   /**
    * @brief This method is used to feed the inputs to the layer
    *
-   * @param inputs An Eigen::MatrixXd representing the inputs (features)
+   * @param inputs A Matrix representing the inputs (features)
    *
-   * @return an Eigen::MatrixXd representing the outputs of the layer
+   * @return a reference to the layer's outputs
    */
-  virtual Eigen::MatrixXd feedInputs(Eigen::MatrixXd inputs,
-                                     bool training = false) override {
+  virtual const Matrix &feedInputs(const ConstMatrixRef &inputs,
+                                   bool training = false) override {
     // Dense layer positioned as input layer
     if (weights.rows() == 0 && weights.cols() == 0) {
       setOutputs(inputs);
-      return inputs;
+      return outputs;
     }
 
+    // Samples passed as columns
     if (inputs.cols() != weights.rows()) {
-      Eigen::MatrixXd transposedMat = inputs.transpose();
-      inputs = transposedMat;
+      assert(inputs.rows() == weights.rows());
+      this->computeOutputs(inputs.transpose(), training);
+      return outputs;
     }
 
-    assert(inputs.cols() == weights.rows());
-    return this->computeOutputs(inputs, training);
+    this->computeOutputs(inputs, training);
+    return outputs;
   };
 
   ~Dense(){};
@@ -86,18 +93,24 @@ class Dense : public Layer {
   // non-public serialization
   friend class cereal::access;
   friend class Network;
+  friend class InferenceSession;
 
   double bias;
   std::string slug = "dns";
+  // Bias and activation tiles, 16K scalars (128KB in double) fit in L2
+  static constexpr int tileScalars = 1 << 14;
   std::string activationSlug = "";
-  Eigen::MatrixXd biases;
   WEIGHT_INIT weightInit;
-  Eigen::MatrixXd weights;
-  Eigen::MatrixXd cachedWeights;
-  Eigen::MatrixXd cachedBiases;
+  int nInputs = 0;  // 0 for an input layer, which has no parameters
+  // Memory of the parameters : the layer's own until the network gathers the
+  // parameters of all its layers in a single arena
+  std::shared_ptr<ParameterArena> arena;
+  size_t offset = 0;  // Offset of the weights in the arena (biases follow)
+  ParameterMap weights{nullptr, 0, 0};
+  ParameterMap biases{nullptr, 0, 0};
   ACTIVATION activation;
-  Eigen::MatrixXd (*activate)(const Eigen::MatrixXd &);
-  Eigen::MatrixXd (*diff)(const Eigen::MatrixXd &);
+  bool keepLogits = false;  // Set by the network for a fused softmax head
+  Matrix logits;  // Weighted sums before the activation (if kept)
 
   template <class Archive>
   void save(Archive &ar) const {
@@ -106,8 +119,70 @@ class Dense : public Layer {
 
   template <class Archive>
   void load(Archive &ar) {
-    ar(cereal::base_class<Layer>(this), nNeurons, biases, weights, activation);
+    Matrix loadedBiases, loadedWeights;
+    ar(cereal::base_class<Layer>(this), nNeurons, loadedBiases, loadedWeights,
+       activation);
     setActivation(activation);
+
+    nInputs = loadedWeights.rows();
+    bindParameters(std::make_shared<ParameterArena>(getNumParameters()), 0);
+    if (nInputs == 0) return;
+    weights = loadedWeights;
+    biases = loadedBiases;
+  }
+
+  /**
+   * @brief Get the number of scalars the layer's parameters take in an arena
+   */
+  size_t getNumParameters() const {
+    if (nInputs == 0) return 0;
+    return ParameterArena::blockSize(nInputs, nNeurons) +
+           ParameterArena::blockSize(1, nNeurons);
+  }
+
+  /**
+   * @brief Moves the parameters into a block of the given arena, keeping
+   * their values
+   *
+   * @param arena The arena
+   * @param offset The offset of the block (`getNumParameters` scalars)
+   */
+  void bindParameters(const std::shared_ptr<ParameterArena> &arena,
+                      size_t offset) {
+    if (nInputs > 0) {
+      ParameterMap newWeights = arena->parameters(offset, nInputs, nNeurons);
+      ParameterMap newBiases = arena->parameters(
+          offset + ParameterArena::blockSize(nInputs, nNeurons), 1, nNeurons);
+      if (weights.size() == newWeights.size()) {
+        newWeights = weights;
+        newBiases = biases;
+      }
+
+      // Rebinding the views (placement new, as documented by Eigen)
+      new (&weights) ParameterMap(newWeights.data(), nInputs, nNeurons);
+      new (&biases) ParameterMap(newBiases.data(), 1, nNeurons);
+    }
+
+    this->arena = arena;
+    this->offset = offset;
+  }
+
+  /**
+   * @brief View of the weights gradient in a buffer laid out like the
+   * gradients of the arena (the arena's own or a worker's)
+   */
+  ParameterMap weightsGradient(Scalar *gradients) const {
+    return ParameterMap(gradients + offset, nInputs, nNeurons);
+  }
+
+  /**
+   * @brief View of the biases gradient in a buffer laid out like the
+   * gradients of the arena
+   */
+  ParameterMap biasesGradient(Scalar *gradients) const {
+    return ParameterMap(
+        gradients + offset + ParameterArena::blockSize(nInputs, nNeurons), 1,
+        nNeurons);
   }
 
   /**
@@ -116,13 +191,15 @@ class Dense : public Layer {
    * layer that's unkown prior
    */
   void init(int numRows) override {
-    // First and foremost init the biases and the outputs
+    // First and foremost allocate the parameters and init the biases
+    nInputs = numRows;
+    bindParameters(std::make_shared<ParameterArena>(getNumParameters()), 0);
+    biases.setConstant(static_cast<Scalar>(bias));
     double mean = 0, stddev = 0;
-    this->weights = Eigen::MatrixXd::Zero(numRows, nNeurons);
 
     // This is going to be used for testing
     if (this->weightInit == WEIGHT_INIT::CONSTANT) {
-      this->weights = Eigen::MatrixXd::Constant(numRows, nNeurons, 1);
+      this->weights.setConstant(1);
       return;
     }
 
@@ -145,9 +222,10 @@ class Dense : public Layer {
     }
 
     // Init the weights
+    Philox generator = randomGenerator();
     this->weightInit == WEIGHT_INIT::RANDOM
-        ? randomWeightInit(&(this->weights), -1, 1)
-        : randomDistMatrixInit(&(this->weights), mean, stddev);
+        ? fillUniform(this->weights, generator, -1, 1)
+        : fillNormal(this->weights, generator, mean, stddev);
   }
 
   /**
@@ -156,28 +234,98 @@ class Dense : public Layer {
    * @param inputs A vector of vectors of doubles representing the inputs
    * (features)
    *
-   * @return an Eigen::MatrixXd representing the computed outputs based on the
-   * layer's parameters
-   */
-  Eigen::MatrixXd computeOutputs(Eigen::MatrixXd inputs,
-                                 bool training) override {
-    // Initialize the biases based on the input's size
-    if (biases.rows() == 0 && biases.cols() == 0) {
-      biases = Eigen::MatrixXd::Constant(1, nNeurons, bias);
+   * @note The outputs buffer is only reallocated when the batch size changes
+   *
+   * The weighted sums of the whole batch are computed by a single GEMM (the
+   * weights are read once per batch), the biases and the activation are then
+   * applied in a single pass, by tiles of rows small enough to stay in cache.
+   * The tiles hold at most 16K scalars, or a single row for the layers that
+   * have more neurons.
+   */
+  void computeOutputs(const ConstMatrixRef &inputs,
+                      bool /*training*/) override {
+    forward(inputs, outputs, keepLogits ? &logits : nullptr);
+  };
+
+  /**
+   * @brief Computes the outputs of the given inputs into external buffers,
+   * without modifying the layer. It's used
+   * by the workers of a data-parallel training.
+   *
+   * @param inputs The inputs (one sample per row)
+   * @param outputs The matrix in which the outputs are written
+   * @param logits The matrix in which the weighted sums are written (optional)
+   */
+  void forward(const ConstMatrixRef &inputs, Matrix &outputs,
+               Matrix *logits) const {
+    outputs.resize(inputs.rows(), nNeurons);
+    if (logits) logits->resize(inputs.rows(), nNeurons);
+
+    // Static dispatch, the activation is inlined in the tiles loop
+    switch (activation) {
+      case ACTIVATION::SIGMOID:
+        return computeTiles<Sigmoid>(inputs, outputs, logits);
+      case ACTIVATION::RELU:
+        return computeTiles<Relu>(inputs, outputs, logits);
+      case ACTIVATION::SOFTMAX:
+        return computeTiles<Softmax>(inputs, outputs, logits);
+      default:
+        return computeTiles<Activation>(inputs, outputs, logits);
     }
+  }
 
-    // Weighted sum
-    Eigen::MatrixXd wSum = inputs * weights;
+  template <typename Act>
+  void computeTiles(const ConstMatrixRef &inputs, Matrix &outputs,
+                    Matrix *logits) const {
+    const int nRows = inputs.rows();
+    const int tileRows = std::max(1, tileScalars / nNeurons);
 
-    wSum.rowwise() += biases.row(0);
+    outputs.noalias() = inputs * weights;
 
-    Eigen::MatrixXd a = activate(wSum);
+    // Biases and activation fused while each tile is cache resident
+    for (int r = 0; r < nRows; r += tileRows) {
+      const int n = std::min(tileRows, nRows - r);
+      auto tile = outputs.middleRows(r, n);
 
-    // Caching outputs for training
-    if (training) outputs = a;
+      tile.rowwise() += biases.row(0);
+      if (logits) logits->middleRows(r, n) = tile;
+      Act::activate(tile, tile);
+    }
+  }
 
-    return a;
-  };
+  /**
+   * @brief Backpropagates a gradient through the layer's activation
+   *
+   * @param grad The gradient of the loss w.r.t the layer's outputs
+   * @param delta The matrix in which the gradient of the loss w.r.t the
+   * weighted sums is written, it must have the shape of the outputs
+   */
+  void backward(const ConstMatrixRef &grad, MatrixRef delta) const {
+    backward(outputs, grad, delta);
+  }
+
+  /**
+   * @brief Backpropagates a gradient through the activation of the given
+   * outputs (computed by `forward`)
+   *
+   * @param a The outputs
+   * @param grad The gradient of the loss w.r.t the outputs
+   * @param delta The matrix in which the gradient of the loss w.r.t the
+   * weighted sums is written, it must have the shape of the outputs
+   */
+  void backward(const ConstMatrixRef &a, const ConstMatrixRef &grad,
+                MatrixRef delta) const {
+    switch (activation) {
+      case ACTIVATION::SIGMOID:
+        return Sigmoid::backward(a, grad, delta);
+      case ACTIVATION::RELU:
+        return Relu::backward(a, grad, delta);
+      case ACTIVATION::SOFTMAX:
+        return Softmax::backward(a, grad, delta);
+      default:
+        return Activation::backward(a, grad, delta);
+    }
+  }
 
   /**
    * @brief This method is used to set the activation function of the layer
@@ -187,26 +335,17 @@ class Dense : public Layer {
    * @return void
    */
   void setActivation(ACTIVATION activation) {
-    if (type == LayerType::FLATTEN) {
-      this->activate = Activation::activate;
-      this->diff = Activation::diff;
-      return;
-    }
+    if (type == LayerType::FLATTEN) return;
 
+    // The activation itself is dispatched in `computeOutputs` and `backward`
     switch (activation) {
       case ACTIVATION::SIGMOID:
-        this->activate = Sigmoid::activate;
-        this->diff = Sigmoid::diff;
         this->activationSlug = Sigmoid::slug;
         break;
       case ACTIVATION::RELU:
-        this->activate = Relu::activate;
-        this->diff = Relu::diff;
         this->activationSlug = Relu::slug;
         break;
       case ACTIVATION::SOFTMAX:
-        this->activate = Softmax::activate;
-        this->diff = Softmax::diff;
         this->activationSlug = Softmax::slug;
         break;
       /**
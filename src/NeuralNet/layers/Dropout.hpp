@@ -1,24 +1,21 @@
 #pragma once
 
-#include <algorithm>
 #include <cereal/access.hpp>
 #include <cereal/archives/binary.hpp>
 #include <cereal/archives/portable_binary.hpp>
 #include <cereal/cereal.hpp>
 #include <cereal/types/base_class.hpp>
 #include <cereal/types/polymorphic.hpp>
-#include <iterator>
-#include <random>
-#include <tuple>
 
 #include "Layer.hpp"
+#include "utils/Random.hpp"
 
 namespace NeuralNet {
 class Dropout : public Layer {
  public:
   float rate, scaleRate;
   unsigned int seed;
-  Eigen::MatrixXd mask;
+  MaskMatrix mask;  // Kept inputs of the last training batch
 
   /**
    * @brief The Dropout layer randomly sets input units to 0 with a frequency of
@@ -27,9 +24,11 @@ class Dropout : public Layer {
    * all inputs is unchanged.
    *
    * @param rate Frequency of units set to 0
-   * @param seed An integer to use as a random seed
+   * @param seed An integer to use as a random seed (0 : a generator from
+   * `randomGenerator`, seeded by `setRandomSeed`)
    */
-  Dropout(float rate, unsigned int seed = 0) : rate(rate), seed(seed) {
+  Dropout(float rate, unsigned int seed = 0)
+      : rate(rate), seed(seed), generator(makeGenerator(seed)) {
     assert(rate < 1 && rate > 0);
     this->type = LayerType::DROPOUT;
     this->trainingOnly = true;  // Training only layer
@@ -46,39 +45,39 @@ class Dropout : public Layer {
   /**
    * @brief This method is used to feed the inputs to the layer
    *
-   * @param inputs An Eigen::MatrixXd representing the inputs (features)
+   * @param inputs A Matrix representing the inputs (features)
    *
-   * @return an Eigen::MatrixXd representing the outputs of the layer
+   * @return a reference to the layer's outputs
    */
-  Eigen::MatrixXd feedInputs(Eigen::MatrixXd inputs,
-                             bool training = false) override {
-    return this->computeOutputs(inputs, training);
+  const Matrix &feedInputs(const ConstMatrixRef &inputs,
+                           bool training = false) override {
+    this->computeOutputs(inputs, training);
+    return outputs;
   };
 
  private:
-  std::vector<std::tuple<int, int>> coordinates;
   std::string slug = "do";
+  // Seeded once, each mask is drawn further in the stream
+  Philox generator;
 
   // non-public serialization
   friend class cereal::access;
+  friend class Network;
 
   Dropout(){};  // Necessary for serialization
 
   template <class Archive>
   void serialize(Archive& ar) {
     ar(cereal::base_class<Layer>(this), seed, rate);
+    if constexpr (Archive::is_loading::value) {
+      scaleRate = 1.0 / (1.0 - rate);
+      generator = makeGenerator(seed);
+    }
   }
 
-  /**
-   * @brief Check seed before generating one randomly
-   *
-   * @return seed
-   */
-  unsigned int getSeed() {
-    if (seed != 0) return seed;
-    std::random_device rd;
-    return rd();
-  };
+  static Philox makeGenerator(unsigned int seed) {
+    return seed != 0 ? Philox(seed) : randomGenerator();
+  }
 
  protected:
   /**
@@ -91,48 +90,53 @@ class Dropout : public Layer {
    *
    * @param inputs A matrix representing the inputs (features)
    *
-   * @return Inputs with some dropped values (zero-ed values) randomly
+   * @note The inputs with some dropped values (zero-ed values) randomly are
+   * written in the layer's outputs
    */
-  Eigen::MatrixXd computeOutputs(Eigen::MatrixXd inputs,
-                                 bool training) override {
-    int rows = inputs.rows();
-    int cols = inputs.cols();
-    int numCoord = rows * cols;  // Number of coordinates
-    mask = Eigen::MatrixXd::Constant(rows, cols, 1);
-
-    seed = getSeed();
-    std::mt19937 gen(seed);
-    const int num_zeros = static_cast<int>(numCoord * (1.0 - rate));
-
-    std::vector<std::tuple<int, int>> randCoordinates;
-
-    randCoordinates.reserve(num_zeros);
-
-    if (!coordinates.size() || coordinates.size() != (numCoord)) {
-      coordinates.clear();
-      coordinates.reserve(numCoord);
-
-      for (int i = 0; i < rows; i++) {
-        for (int j = 0; j < cols; j++) {
-          coordinates.emplace_back(std::make_tuple(i, j));
-        }
-      }
-    }
-
-    // Randomly select tuples from coordinates
-    std::sample(coordinates.begin(), coordinates.end(),
-                std::back_inserter(randCoordinates), num_zeros, gen);
+  void computeOutputs(const ConstMatrixRef &inputs,
+                      bool /*training*/) override {
+    drawMask(inputs.rows(), inputs.cols());
 
-    for (std::tuple<int, int>& coord : randCoordinates) {
-      mask(std::get<0>(coord), std::get<1>(coord)) = 0;
-    }
+    outputs.resize(inputs.rows(), inputs.cols());
+    applyMask(mask, inputs, outputs);
+  };
 
-    Eigen::MatrixXd dO = (inputs.array() * mask.array()) * scaleRate;
+  /**
+   * @brief Zeroes the dropped values and scales up the kept ones. Used in the
+   * forward pass and, in place, on the gradients of the backward pass.
+   *
+   * @param mask The mask of the kept values
+   * @param values The values (inputs or gradients)
+   * @param out The destination, can be `values` itself
+   */
+  void applyMask(const MaskMatrix &mask, const ConstMatrixRef &values,
+                 MatrixRef out) const {
+    assert(mask.rows() == values.rows() && mask.cols() == values.cols());
+    out.array() = values.array() * mask.array().cast<Scalar>() *
+                  static_cast<Scalar>(scaleRate);
+  };
 
-    // Caching outputs for training
-    if (training) outputs = dO;
+  /**
+   * @brief Draws the mask of the kept inputs, each one is dropped
+   * independently with a probability of `rate`
+   *
+   * @param rows The number of samples
+   * @param cols The number of inputs per sample
+   */
+  void drawMask(int rows, int cols) { drawMask(rows, cols, generator, mask); };
 
-    return dO;
+  /**
+   * @brief Draws a mask into the given matrix without modifying the layer
+   * (used by the asynchronous training workers)
+   *
+   * @param rows The number of samples
+   * @param cols The number of inputs per sample
+   * @param gen The worker's random generator
+   * @param mask The matrix in which the mask is written
+   */
+  void drawMask(int rows, int cols, Philox& gen, MaskMatrix& mask) const {
+    mask.resize(rows, cols);
+    gen.fillBernoulli(mask.data(), mask.size(), 1.0 - rate);
   };
 };
 }  // namespace NeuralNet
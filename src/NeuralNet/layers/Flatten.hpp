@@ -34,38 +34,29 @@ class Flatten : public Layer {
   std::string getSlug() const override { return slug; }
 
   /**
-   * @brief This method flattens a 3D vector into a 2D Eigen::MatrixXd
+   * @brief Get the shape of the samples the layer flattens
+   */
+  std::tuple<int, int> getInputShape() const { return inputShape; }
+
+  /**
+   * @brief This method flattens a 3D vector into a 2D Matrix
    *
    * @param inputs The 3D vector to be flattened
-   * @return Eigen::MatrixXd The flattened 2D Eigen::MatrixXd
+   * @return Matrix The flattened 2D Matrix
    */
-  Eigen::MatrixXd flatten(
-      std::vector<std::vector<std::vector<double>>> inputs) {
-    int rows = std::get<0>(inputShape);
-    int cols = std::get<1>(inputShape);
-
-    // Flatten the vectors
-    std::vector<double> flatInputs;
-    for (const std::vector<std::vector<double>> &input : inputs) {
-      std::vector<double> flattenedInput = flatten2DVector(input, rows, cols);
-      flatInputs.insert(flatInputs.end(), flattenedInput.begin(),
-                        flattenedInput.end());
-    }
-
-    const int numRows = inputs.size();
-    const int numCols = rows * cols;
-    return Eigen::Map<
-        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
-        flatInputs.data(), numRows, numCols);
+  Matrix flatten(const std::vector<std::vector<std::vector<double>>> &inputs) {
+    Matrix flattened;
+    flattenInto(inputs, flattened);
+    return flattened;
   };
 
-  void feedInputs(std::vector<std::vector<std::vector<double>>> inputs,
+  void feedInputs(const std::vector<std::vector<std::vector<double>>> &inputs,
                   bool training) override {
-    Eigen::MatrixXd flattenedInputs = flatten(inputs);
-    this->setOutputs(flattenedInputs);
+    flattenInto(inputs, outputs);
   };
 
-  Eigen::MatrixXd feedInputs(Eigen::MatrixXd inputs, bool training) override {
+  const Matrix &feedInputs(const ConstMatrixRef &inputs,
+                           bool training) override {
     this->setOutputs(inputs);
     return outputs;
   };
@@ -75,6 +66,7 @@ class Flatten : public Layer {
  private:
   // non-public serialization
   friend class cereal::access;
+  friend class InferenceSession;
 
   std::tuple<int, int> inputShape;
   std::string slug = "fltn";
@@ -84,9 +76,27 @@ class Flatten : public Layer {
     ar(cereal::base_class<Layer>(this), inputShape);
   }
 
-  Eigen::MatrixXd computeOutputs(Eigen::MatrixXd inputs,
-                                 bool training) override {
-    return outputs;
+  void computeOutputs(const ConstMatrixRef &inputs, bool training) override {}
+
+  /**
+   * @brief Flattens the samples straight into the given matrix, one sample per
+   * row (only reallocated when the number of samples changes)
+   */
+  void flattenInto(const std::vector<std::vector<std::vector<double>>> &inputs,
+                   Matrix &flattened) const {
+    const int rows = std::get<0>(inputShape);
+    const int cols = std::get<1>(inputShape);
+
+    flattened.resize(inputs.size(), rows * cols);
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+      assert(inputs[i].size() == static_cast<size_t>(rows));
+      for (int r = 0; r < rows; r++) {
+        assert(inputs[i][r].size() == static_cast<size_t>(cols));
+        flattened.block(i, r * cols, 1, cols) =
+            Eigen::RowVectorXd::Map(inputs[i][r].data(), cols).cast<Scalar>();
+      }
+    }
   }
 
   Flatten(){};  // Necessary for serializations
@@ -25,6 +25,7 @@ enum class LayerType { DEFAULT, DENSE, FLATTEN, DROPOUT };
 
 class Layer {
   friend class Network;
+  friend class InferenceSession;
 
  public:
   Layer(){};
@@ -32,9 +33,9 @@ class Layer {
   /**
    * @brief This method get the layer's outputs
    *
-   * @return an Eigen::Eigen::MatrixXd  representing the layer's outputs
+   * @return a Matrix  representing the layer's outputs
    */
-  Eigen::MatrixXd getOutputs() const { return outputs; };
+  const Matrix &getOutputs() const { return outputs; };
 
   /**
    * @brief This method get the number of neurons actually in the layer
@@ -63,22 +64,27 @@ class Layer {
    *
    * @param inputs A vector of doubles representing the inputs (features)
    *
-   * @return an Eigen::MatrixXd representing the outputs of the layer
+   * @return a Matrix representing the outputs of the layer
    */
-  virtual Eigen::MatrixXd feedInputs(std::vector<double> inputs,
-                                     bool training = false) {
-    return this->feedInputs(Eigen::MatrixXd::Map(&inputs[0], inputs.size(), 1));
+  const Matrix &feedInputs(const std::vector<double> &inputs,
+                           bool training = false) {
+    // Single sample, hence a row
+    const Matrix sample =
+        Eigen::RowVectorXd::Map(inputs.data(), inputs.size()).cast<Scalar>();
+    return this->feedInputs(sample, training);
   };
 
   /**
    * @brief This method is used to feed the inputs to the layer
    *
-   * @param inputs An Eigen::MatrixXd representing the inputs (features)
+   * @param inputs A Matrix representing the inputs (features), one sample per
+   * row
    *
-   * @return an Eigen::MatrixXd representing the outputs of the layer
+   * @return a reference to the layer's outputs buffer, which is overwritten by
+   * the next call
    */
-  virtual Eigen::MatrixXd feedInputs(Eigen::MatrixXd inputs,
-                                     bool training = false) = 0;
+  virtual const Matrix &feedInputs(const ConstMatrixRef &inputs,
+                                   bool training = false) = 0;
 
   /**
    * @brief This method is used to feed the inputs to the layer
@@ -88,8 +94,9 @@ class Layer {
    *
    * @return void
    */
-  virtual void feedInputs(std::vector<std::vector<std::vector<double>>> inputs,
-                          bool training = false) {
+  virtual void feedInputs(
+      const std::vector<std::vector<std::vector<double>>> &inputs,
+      bool training = false) {
     assert(false &&
            "Cannot feed 3d vectors, a Flatten layer could do it though");
     return;
@@ -133,14 +140,14 @@ class Layer {
 
  protected:
   int nNeurons;
-  Eigen::MatrixXd outputs;
+  Matrix outputs;  // Reused across calls, only resized with the batch size
   LayerType type = LayerType::DEFAULT;
   bool trainingOnly = false;  // If true skip during inferences
 
   /**
    * @param outputs the outputs to store
    */
-  void setOutputs(Eigen::MatrixXd outputs)  // used for the Flatten Layer
+  void setOutputs(const ConstMatrixRef &outputs)  // used for the Flatten Layer
   {
     this->outputs = outputs;
   };
@@ -155,10 +162,10 @@ class Layer {
    * @note This method is used for the input layer (the first layer of the
    * network)
    */
-  void setOutputs(std::vector<double> outputs) {
+  void setOutputs(const std::vector<double> &outputs) {
     assert(outputs.size() == nNeurons);
-    this->outputs =
-        Eigen::MatrixXd ::Map(&outputs[0], this->getNumNeurons(), 1);
+    this->outputs = Eigen::MatrixXd::Map(&outputs[0], this->getNumNeurons(), 1)
+                        .cast<Scalar>();
   };
 
   /**
@@ -167,11 +174,10 @@ class Layer {
    * @param inputs A vector of vectors of doubles representing the inputs
    * (features)
    *
-   * @return an Eigen::MatrixXd representing the computed outputs based on the
-   * layer's parameters
+   * @note The outputs are computed in place in the layer's outputs buffer
    */
-  virtual Eigen::MatrixXd computeOutputs(Eigen::MatrixXd inputs,
-                                         bool training = false) = 0;
+  virtual void computeOutputs(const ConstMatrixRef &inputs,
+                              bool training = false) = 0;
 
   /**
    * This function will be used to properly initialize the Layer
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cmath>
+#include <stdexcept>
+
 #include "Loss.hpp"
 #include "utils/Functions.hpp"
 
@@ -9,28 +12,36 @@ namespace NeuralNet {
  */
 class BCE : public Loss {
  public:
-  static double cmpLoss(const Eigen::MatrixXd &o, const Eigen::MatrixXd &y) {
-    constexpr double threshold = 1.0e-5;
-    Eigen::MatrixXd oThresh = thresh(o, threshold);
-    Eigen::MatrixXd yThresh = thresh(y, threshold);
+  static double cmpLoss(const Matrix &o, const Matrix &y) {
+    constexpr Scalar threshold = 1.0e-5;
+    // Same as `thresh` but lazily evaluated, nothing is allocated
+    const auto oThresh = (o.array() < threshold).select(threshold, o.array());
+    const auto yThresh = (y.array() < threshold).select(threshold, y.array());
 
-    Eigen::MatrixXd loss =
-        -(yThresh.array() * oThresh.array().log() +
-          (1.0 - yThresh.array()) * (1.0 - oThresh.array()).log());
+    const double loss =
+        -(yThresh * oThresh.log() + (1.0 - yThresh) * (1.0 - oThresh).log())
+             .sum();
 
-    if (loss.array().isNaN().any())
+    // A single NaN value makes the whole sum NaN
+    if (std::isnan(loss))
       throw std::runtime_error(
           "NaN value encountered. Inputs might be too big");
 
-    return loss.sum();
+    return loss;
   }
 
-  static Eigen::MatrixXd cmpLossGrad(const Eigen::MatrixXd &yHat,
-                                     const Eigen::MatrixXd &y) {
-    constexpr double epsilon = 1.0e-9;
+  static Matrix cmpLossGrad(const Matrix &yHat, const Matrix &y) {
+    constexpr Scalar epsilon = 1.0e-9;
     return (yHat.array() - y.array()) /
            ((yHat.array() * (1.0 - yHat.array())) + epsilon);
   }
+
+  static void cmpLossGrad(const Matrix &yHat, const Matrix &y, Matrix &grad) {
+    constexpr Scalar epsilon = 1.0e-9;
+    grad.resize(yHat.rows(), yHat.cols());
+    grad.array() = (yHat.array() - y.array()) /
+                   ((yHat.array() * (1.0 - yHat.array())) + epsilon);
+  }
 };
 
 }  // namespace NeuralNet
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <Eigen/Dense>
 
+#include "utils/Types.hpp"
+
 namespace NeuralNet {
 class Loss {
  public:
@@ -13,7 +15,7 @@ class Loss {
    *
    * @return The loss based on the selected loss function
    */
-  static double cmpLoss(const Eigen::MatrixXd &o, const Eigen::MatrixXd &y);
+  static double cmpLoss(const Matrix &o, const Matrix &y);
 
   /**
    * @brief This function computes the loss gradient w.r.t the outputs
@@ -23,7 +25,17 @@ class Loss {
    *
    * @return The current iteration's gradient
    */
-  static Eigen::MatrixXd cmpLossGrad(const Eigen::MatrixXd &yHat,
-                                     const Eigen::MatrixXd &y);
+  static Matrix cmpLossGrad(const Matrix &yHat, const Matrix &y);
+
+  /**
+   * @brief This function computes the loss gradient w.r.t the outputs into the
+   * given matrix
+   *
+   * @param yHat The outputs from the output layer
+   * @param y The labels (expected vals)
+   * @param grad The matrix in which the gradient is written (only reallocated
+   * when its shape differs)
+   */
+  static void cmpLossGrad(const Matrix &yHat, const Matrix &y, Matrix &grad);
 };
 }  // namespace NeuralNet
\ No newline at end of file
@@ -8,16 +8,19 @@ namespace NeuralNet {
  */
 class MCE : public Loss {
  public:
-  static double cmpLoss(const Eigen::MatrixXd &o, const Eigen::MatrixXd &y) {
-    Eigen::MatrixXd cMatrix = y.array() * o.array().log();
-
-    return -cMatrix.sum();
+  static double cmpLoss(const Matrix &o, const Matrix &y) {
+    return -(y.array() * o.array().log()).sum();
   };
 
-  static Eigen::MatrixXd cmpLossGrad(const Eigen::MatrixXd &yHat,
-                                     const Eigen::MatrixXd &y) {
+  static Matrix cmpLossGrad(const Matrix &yHat, const Matrix &y) {
     assert(yHat.rows() == y.rows() && yHat.cols() == y.cols());
     return yHat.array() - y.array();
   };
+
+  static void cmpLossGrad(const Matrix &yHat, const Matrix &y, Matrix &grad) {
+    assert(yHat.rows() == y.rows() && yHat.cols() == y.cols());
+    grad.resize(yHat.rows(), yHat.cols());
+    grad.array() = yHat.array() - y.array();
+  };
 };
 }  // namespace NeuralNet
\ No newline at end of file
@@ -9,17 +9,19 @@ namespace NeuralNet {
  */
 class Quadratic : public Loss {
  public:
-  static double cmpLoss(const Eigen::MatrixXd &o, const Eigen::MatrixXd &y) {
-    Eigen::MatrixXd cMatrix = o.array() - y.array();
-    cMatrix = cMatrix.unaryExpr(&sqr);
-
-    return cMatrix.sum();
+  static double cmpLoss(const Matrix &o, const Matrix &y) {
+    return (o.array() - y.array()).square().sum();
   };
 
-  static Eigen::MatrixXd cmpLossGrad(const Eigen::MatrixXd &yHat,
-                                     const Eigen::MatrixXd &y) {
+  static Matrix cmpLossGrad(const Matrix &yHat, const Matrix &y) {
     assert(yHat.rows() == y.rows());
     return (yHat.array() - y.array()).matrix() * 2;
   };
+
+  static void cmpLossGrad(const Matrix &yHat, const Matrix &y, Matrix &grad) {
+    assert(yHat.rows() == y.rows());
+    grad.resize(yHat.rows(), yHat.cols());
+    grad.array() = (yHat.array() - y.array()) * 2;
+  };
 };
 }  // namespace NeuralNet
\ No newline at end of file
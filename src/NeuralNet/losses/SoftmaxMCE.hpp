@@ -0,0 +1,68 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+
+#include "Loss.hpp"
+#include "activations/Softmax.hpp"
+
+namespace NeuralNet {
+/**
+ * Softmax activation fused with the Multi-class Cross Entropy (output head).
+ *
+ * The loss is computed from the output layer's logits with the log-sum-exp
+ * trick, so it stays finite for large logits, and the gradient w.r.t the
+ * logits simplifies to `p - y` (the softmax derivative isn't needed).
+ */
+class SoftmaxMCE : public Loss {
+ public:
+  /**
+   * @brief Computes the loss from the logits
+   *
+   * @param logits The output layer's weighted sums (before the softmax)
+   * @param y The labels (the expected values)
+   *
+   * @return -sum(y * log(softmax(logits)))
+   */
+  static double cmpLoss(const Matrix &logits, const Matrix &y) {
+    assert(logits.rows() == y.rows() && logits.cols() == y.cols());
+    Softmax::ChunkArray max, lse;
+    double loss = 0;
+
+    for (int r = 0; r < logits.rows(); r += Softmax::chunkRows) {
+      const int n = std::min<int>(Softmax::chunkRows, logits.rows() - r);
+      auto z = logits.middleRows(r, n);
+      auto yChunk = y.middleRows(r, n);
+
+      Softmax::rowsMax(z, max);
+
+      lse.head(n).setZero();
+      for (int c = 0; c < z.cols(); c++) {
+        lse.head(n) += (z.col(c).array() - max.head(n)).exp();
+      }
+      lse.head(n) = max.head(n) + lse.head(n).log();
+
+      // -sum(y * (z - lse))
+      for (int c = 0; c < z.cols(); c++) {
+        loss -=
+            (yChunk.col(c).array() * (z.col(c).array() - lse.head(n))).sum();
+      }
+    }
+
+    return loss;
+  }
+
+  /**
+   * @brief Computes the loss gradient w.r.t the logits
+   *
+   * @param p The softmax outputs
+   * @param y The labels (expected vals)
+   * @param grad The matrix in which the gradient is written
+   */
+  static void cmpLossGrad(const Matrix &p, const Matrix &y, Matrix &grad) {
+    assert(p.rows() == y.rows() && p.cols() == y.cols());
+    grad.resize(p.rows(), p.cols());
+    grad.array() = p.array() - y.array();
+  }
+};
+}  // namespace NeuralNet
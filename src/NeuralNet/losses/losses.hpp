@@ -8,3 +8,4 @@
 #include "BCE.hpp"  // Binary Cross-Entropy
 #include "MCE.hpp"  // Multiclass Cross-Entropy
 #include "Quadratic.hpp"
+#include "SoftmaxMCE.hpp"  // Fused softmax + Multiclass Cross-Entropy head
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 
 #include "Optimizer.hpp"
@@ -23,94 +25,128 @@ class Adam : public Optimizer {
    */
   Adam(double alpha = 0.001, double beta1 = 0.9, double beta2 = 0.999,
        double epsilon = 10E-8)
-      : Optimizer(alpha) {
-    this->beta1 = beta1;
-    this->beta2 = beta2;
-    this->epsilon = epsilon;
-  };
+      : Adam(alpha, beta1, beta2, epsilon, 0){};
 
   ~Adam() override = default;
 
-  void updateWeights(Eigen::MatrixXd &weights,
-                     const Eigen::MatrixXd &weightsGrad) override {
-    this->update(weights, weightsGrad, mWeights[cl], vWeights[cl]);
+  void updateWeights(MatrixRef weights,
+                     const ConstMatrixRef &weightsGrad) override {
+    this->fusedUpdate(weights, weightsGrad, stateOf(mBuffer, weights),
+                      stateOf(vBuffer, weights));
   };
 
-  void updateBiases(Eigen::MatrixXd &biases,
-                    const Eigen::MatrixXd &biasesGrad) override {
-    this->update(biases, biasesGrad, mBiases[cl], vBiases[cl]);
-    this->setCurrentL();
+  void updateBiases(MatrixRef biases,
+                    const ConstMatrixRef &biasesGrad) override {
+    this->fusedUpdate(biases, biasesGrad, stateOf(mBuffer, biases),
+                      stateOf(vBuffer, biases));
   };
 
-  template <typename Derived1, typename Derived2>
-  void update(Eigen::MatrixBase<Derived1> &param,
-              const Eigen::MatrixBase<Derived2> &gradients,
-              Eigen::MatrixBase<Derived1> &m, Eigen::MatrixBase<Derived1> &v) {
-    assert(param.rows() == gradients.rows() &&
-           param.cols() == gradients.cols());
-
-    // increment time step
-    t = t + 1;
+  /**
+   * @brief Performs a whole step on a single tensor, with the given moments
+   * (ex: outside of a network)
+   *
+   * @param param The parameters to update
+   * @param gradients The gradients of the parameters
+   * @param m The first moments of the parameters
+   * @param v The second moments of the parameters
+   */
+  void update(MatrixRef param, const ConstMatrixRef &gradients, MatrixRef m,
+              MatrixRef v) {
+    this->beginStep();
+    this->fusedUpdate(param, gradients, m, v);
+  }
 
-    if (m.rows() == 0 || m.cols() == 0) {
-      // Initialize moment matrices m and v
-      m = Eigen::MatrixBase<Derived1>::Zero(param.rows(), param.cols());
-      v = Eigen::MatrixBase<Derived1>::Zero(param.rows(), param.cols());
-    }
+ protected:
+  double weightDecay;  // Decoupled weight decay (AdamW)
+
+  Adam(double alpha, double beta1, double beta2, double epsilon,
+       double weightDecay)
+      : Optimizer(alpha),
+        weightDecay(weightDecay),
+        beta1(beta1),
+        beta2(beta2),
+        epsilon(epsilon){};
+
+  void beginStep() override {
+    // The bias corrections only depend on the step
+    beta1Power *= beta1;
+    beta2Power *= beta2;
+    stepSize = alpha * std::sqrt(1 - beta2Power) / (1 - beta1Power);
+  }
 
-    assert(gradients.rows() == m.rows() && gradients.cols() == m.cols());
-    assert(gradients.rows() == v.rows() && gradients.cols() == v.cols());
+ private:
+  static constexpr Eigen::Index chunkSize = 512;  // Scalars updated at once
 
-    // update biased first moment estimate
-    m = (beta1 * m).array() + ((1 - beta2) * gradients.array()).array();
+  double beta1;
+  double beta2;
+  double epsilon;
+  double beta1Power = 1;  // beta1^t
+  double beta2Power = 1;  // beta2^t
+  double stepSize = 0;  // Bias corrected learning rate of the current step
+  // First and second moments of all the parameters, laid out like the
+  // network's parameters arena
+  AlignedBuffer mBuffer;
+  AlignedBuffer vBuffer;
+
+  void insiderInit(const ParameterArena &arena) override {
+    parameters = arena.parameters();
+    // The bias corrections restart with the moments
+    beta1Power = 1;
+    beta2Power = 1;
+    mBuffer.assign(arena.getSize(), 0);
+    vBuffer.assign(arena.getSize(), 0);
+  }
 
-    // updated biased second raw moment estimate
-    v = (beta2 * v).array() +
-        ((1 - beta2) * (gradients.array() * gradients.array())).array();
+  /**
+   * @brief Updates the parameters and their moments, column by column unless
+   * they're all contiguous
+   */
+  void fusedUpdate(MatrixRef param, const ConstMatrixRef &gradients,
+                   MatrixRef m, MatrixRef v) const {
+    assert(param.rows() == gradients.rows() &&
+           param.cols() == gradients.cols());
+    assert(param.rows() == m.rows() && param.cols() == m.cols());
+    assert(param.rows() == v.rows() && param.cols() == v.cols());
+
+    const Eigen::Index rows = param.rows();
+    if (param.outerStride() == rows && gradients.outerStride() == rows &&
+        m.outerStride() == rows && v.outerStride() == rows) {
+      fusedUpdate(param.data(), gradients.data(), m.data(), v.data(),
+                  param.size());
+      return;
+    }
 
-    // compute bias-corrected first moment estimate
-    double beta1_t = std::pow(beta1, t);
+    for (Eigen::Index c = 0; c < param.cols(); c++) {
+      fusedUpdate(param.col(c).data(), gradients.col(c).data(),
+                  m.col(c).data(), v.col(c).data(), rows);
+    }
+  }
 
-    // compute bias-corrected second raw moment estimate
-    double beta2_t = std::pow(beta2, t);
+  /**
+   * @brief Updates `n` contiguous parameters and their moments in a single
+   * pass : each chunk of the parameters, gradients and moments is read once
+   * and updated while it's in the L1 cache
+   */
+  void fusedUpdate(Scalar *param, const Scalar *gradients, Scalar *m,
+                   Scalar *v, Eigen::Index n) const {
+    using Chunk = Eigen::Map<Eigen::Array<Scalar, Eigen::Dynamic, 1>>;
+    using ConstChunk =
+        Eigen::Map<const Eigen::Array<Scalar, Eigen::Dynamic, 1>>;
 
-    double alpha_t = alpha * (sqrt(1 - beta2_t) / (1 - beta1_t));
+    const Scalar b1 = beta1, b2 = beta2, eps = epsilon;
+    const Scalar step = stepSize, decay = 1 - alpha * weightDecay;
 
-    // update param
-    param =
-        param.array() - alpha_t * (m.array() / (v.array().sqrt() + epsilon));
-  }
+    for (Eigen::Index start = 0; start < n; start += chunkSize) {
+      const Eigen::Index size = std::min(chunkSize, n - start);
+      Chunk p(param + start, size), mc(m + start, size), vc(v + start, size);
+      const ConstChunk g(gradients + start, size);
 
- private:
-  double beta1;
-  double beta2;
-  double epsilon;
-  int t = 0;
-  int cl;  // Current layer (should be initialized to the total number of layers
-           // - 0)
-  int ll;  // Last layer (should also be initialized to numLayers - 1)
-  std::vector<Eigen::MatrixXd> mWeights;  // First-moment vector for weights
-  std::vector<Eigen::MatrixXd> vWeights;  // Second-moment vector for weights
-  std::vector<Eigen::MatrixXd> mBiases;   // First-moment vector for biases
-  std::vector<Eigen::MatrixXd> vBiases;   // Second-moment vector for biases
-
-  void insiderInit(size_t numLayers) override {
-    cl = numLayers - 1;
-    ll = numLayers - 1;
-
-    Eigen::MatrixXd dotMatrix = Eigen::MatrixXd::Zero(0, 0);
-
-    for (int i = mWeights.size(); i < numLayers; i++) {
-      mWeights.push_back(dotMatrix);
-      vWeights.push_back(dotMatrix);
-      mBiases.push_back(dotMatrix);
-      vBiases.push_back(dotMatrix);
-    };
-  }
+      // Biased first and second raw moment estimates
+      mc = b1 * mc + (1 - b1) * g;
+      vc = b2 * vc + (1 - b2) * g.square();
 
-  void setCurrentL() {
-    // If current layer is the first layer set it to the last layer
-    cl = cl == 1 ? ll : cl - 1;
+      p = decay * p - step * mc / (vc.sqrt() + eps);
+    }
   }
 };
 }  // namespace NeuralNet
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Adam.hpp"
+
+namespace NeuralNet {
+/**
+ * Adam optimizer with decoupled weight decay
+ */
+class AdamW : public Adam {
+ public:
+  /**
+   * AdamW decays the parameters separately from Adam's gradient based update
+   * (Loshchilov & Hutter, "Decoupled Weight Decay Regularization"), which
+   * regularizes better than an L2 penalty added to the loss.
+   *
+   * @param alpha Learning rate
+   * @param beta1 Exponential decay rate for the first moment estimates
+   * @param beta2 Exponential decay rate for the second moment estimates
+   * @param epsilon A small constant for numerical stability
+   * @param weightDecay The decay rate of the parameters (scaled by the
+   * learning rate)
+   */
+  AdamW(double alpha = 0.001, double beta1 = 0.9, double beta2 = 0.999,
+        double epsilon = 10E-8, double weightDecay = 0.01)
+      : Adam(alpha, beta1, beta2, epsilon, weightDecay){};
+
+  ~AdamW() override = default;
+};
+}  // namespace NeuralNet
@@ -1,8 +1,26 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "utils/ParameterArena.hpp"
+#include "utils/Types.hpp"
+#include "utils/WorkerPool.hpp"
 
 namespace NeuralNet {
+/**
+ * A tensor of parameters (ex: a layer's weights) and its gradient
+ */
+struct Parameter {
+  ParameterMap value;
+  ConstParameterMap gradient;
+};
+
 class Optimizer {
   friend class Network;
 
@@ -11,6 +29,16 @@ class Optimizer {
 
   virtual ~Optimizer() = default;  // Virtual destructor
 
+  /**
+   * @brief Get the learning rate
+   */
+  double getAlpha() const { return alpha; }
+
+  /**
+   * @brief Set the learning rate (ex: from a learning rate schedule)
+   */
+  void setAlpha(double alpha) { this->alpha = alpha; }
+
   /**
    * @brief This function updates the weights passed based on the selected
    * Optimizer and the weights gradients
@@ -21,8 +49,8 @@ class Optimizer {
    * The function will return void, since it only performs an update on the
    * weights passed
    */
-  virtual void updateWeights(Eigen::MatrixXd &weights,
-                             const Eigen::MatrixXd &weightsGrad) = 0;
+  virtual void updateWeights(MatrixRef weights,
+                             const ConstMatrixRef &weightsGrad) = 0;
 
   /**
    * @brief This function updates the biases passed based based on the Optimizer
@@ -34,21 +62,98 @@ class Optimizer {
    * The function will return void, since it only performs an update on the
    * biases passed
    */
-  virtual void updateBiases(Eigen::MatrixXd &biases,
-                            const Eigen::MatrixXd &biasesGrad) = 0;
+  virtual void updateBiases(MatrixRef biases,
+                            const ConstMatrixRef &biasesGrad) = 0;
+
+  /**
+   * @brief Updates several tensors of parameters (ex: all the layers of a
+   * network) as a single training step
+   *
+   * @param params The parameters and their gradients
+   * @param pool The workers to split the update across, each one updates an
+   * equal share of the scalars (nullptr to update on the calling thread)
+   */
+  void step(const std::vector<Parameter> &params, WorkerPool *pool = nullptr) {
+    this->beginStep();
+
+    // The optimizers update the weights and the biases the same way
+    if (!pool || pool->size() == 1) {
+      for (const Parameter &param : params) {
+        ParameterMap value = param.value;  // The views are shallow
+        this->updateWeights(value, param.gradient);
+      }
+      return;
+    }
+
+    size_t nScalars = 0;
+    for (const Parameter &param : params) nScalars += param.value.size();
+
+    pool->run([&](int w) {
+      const size_t begin = nScalars * w / pool->size();
+      const size_t end = nScalars * (w + 1) / pool->size();
+
+      // Scalars of the worker's share in each tensor, seen as a column
+      size_t start = 0;
+      for (const Parameter &param : params) {
+        const size_t first = std::max(begin, start);
+        const size_t last = std::min<size_t>(end, start + param.value.size());
+        if (first < last) {
+          ParameterMap value = param.value;
+          const Eigen::Index n = last - first;
+          this->updateWeights(
+              Eigen::Map<Matrix>(value.data() + first - start, n, 1),
+              Eigen::Map<const Matrix>(param.gradient.data() + first - start,
+                                       n, 1));
+        }
+        start += param.value.size();
+      }
+    });
+  }
 
  protected:
   double alpha;
+  const Scalar *parameters = nullptr;  // First parameter of the network's arena
 
   /**
    * @brief This function's purpose is to provide an interface to perform
    * updates for the Optimizers from within the network
    *
-   * @param size The size (for now it's only used to init the layer's in the
-   * Adam optimizer)
+   * @param arena The arena of the network's parameters (for now it's only
+   * used by the Adam optimizer, which lays out its moments the same way)
    *
    * This function returns nothing
    */
-  virtual void insiderInit(size_t size) = 0;
+  virtual void insiderInit(const ParameterArena &arena) = 0;
+
+  /**
+   * @brief Called by the network before the updates of each training step
+   * (ex: Adam computes its bias corrections once per step)
+   */
+  virtual void beginStep(){};
+
+  /**
+   * @brief View of the state of the given parameters (or a part of them) in a
+   * buffer laid out like the network's parameters arena (ex: Adam's moments)
+   *
+   * @throw std::runtime_error If the parameters aren't in the arena the
+   * optimizer was set up with (ex: an optimizer shared by two networks)
+   */
+  Eigen::Map<Matrix> stateOf(AlignedBuffer &buffer,
+                             const MatrixRef &param) const {
+    assert(param.outerStride() == param.rows());  // Contiguous in the arena
+
+    // Compared as addresses, the pointers may not be in the same buffer
+    const uintptr_t first = reinterpret_cast<uintptr_t>(parameters);
+    const uintptr_t address = reinterpret_cast<uintptr_t>(param.data());
+    const size_t offset = (address - first) / sizeof(Scalar);
+
+    if (!parameters || address < first ||
+        offset + param.size() > buffer.size())
+      throw std::runtime_error(
+          "The parameters aren't the ones the optimizer was set up with");
+
+    return Eigen::Map<Matrix>(buffer.data() + offset, param.rows(),
+                              param.cols());
+  }
 };
 }  // namespace NeuralNet
\ No newline at end of file
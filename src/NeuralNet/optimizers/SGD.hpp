@@ -8,21 +8,68 @@ namespace NeuralNet {
  */
 class SGD : public Optimizer {
  public:
-  SGD(double alpha) : Optimizer(alpha){};
+  /**
+   * @param alpha Learning rate
+   * @param momentum Momentum factor, the fraction of the previous update
+   * carried over (0 for the plain gradient descent)
+   * @param nesterov Whether to use the Nesterov momentum, which applies the
+   * gradient at the position the momentum leads to
+   */
+  SGD(double alpha, double momentum = 0, bool nesterov = false)
+      : Optimizer(alpha), momentum(momentum), nesterov(nesterov){};
 
   ~SGD() override = default;
 
-  void updateWeights(Eigen::MatrixXd &weights,
-                     const Eigen::MatrixXd &weightsGrad) override {
-    weights = weights.array() - (this->alpha * weightsGrad).array();
+  void updateWeights(MatrixRef weights,
+                     const ConstMatrixRef &weightsGrad) override {
+    this->descend(weights, weightsGrad);
   };
 
-  void updateBiases(Eigen::MatrixXd &biases,
-                    const Eigen::MatrixXd &biasesGrad) override {
-    biases = biases.array() - (this->alpha * biasesGrad).array();
+  void updateBiases(MatrixRef biases,
+                    const ConstMatrixRef &biasesGrad) override {
+    this->descend(biases, biasesGrad);
   };
 
+  /**
+   * @brief Performs a momentum step on a single tensor, with the given
+   * velocity (ex: outside of a network)
+   *
+   * @param param The parameters to update
+   * @param gradients The gradients of the parameters
+   * @param velocity The velocity of the parameters, updated in place
+   */
+  void update(MatrixRef param, const ConstMatrixRef &gradients,
+              MatrixRef velocity) const {
+    const Scalar lr = alpha, mu = momentum;
+
+    velocity = mu * velocity + gradients;
+
+    if (nesterov) {
+      param -= lr * (gradients + mu * velocity);
+    } else {
+      param -= lr * velocity;
+    }
+  }
+
  private:
-  void insiderInit(size_t size) override{};
+  double momentum;
+  bool nesterov;
+  // Velocity of all the parameters, laid out like the network's parameters
+  // arena (allocated once, only with momentum)
+  AlignedBuffer velocities;
+
+  void insiderInit(const ParameterArena &arena) override {
+    parameters = arena.parameters();
+    if (momentum != 0) velocities.assign(arena.getSize(), 0);
+  };
+
+  void descend(MatrixRef param, const ConstMatrixRef &gradients) {
+    if (momentum == 0) {
+      param -= static_cast<Scalar>(this->alpha) * gradients;
+      return;
+    }
+
+    this->update(param, gradients, stateOf(velocities, param));
+  }
 };
-}  // namespace NeuralNet
\ No newline at end of file
+}  // namespace NeuralNet
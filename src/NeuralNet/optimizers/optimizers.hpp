@@ -5,4 +5,5 @@
 #pragma once
 
 #include "Adam.hpp"
+#include "AdamW.hpp"
 #include "SGD.hpp"
\ No newline at end of file
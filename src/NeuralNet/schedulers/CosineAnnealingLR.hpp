@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "LRScheduler.hpp"
+
+namespace NeuralNet {
+/**
+ * Anneals the learning rate from the base rate to a minimum rate along a
+ * half cosine, the rate then stays at the minimum
+ */
+class CosineAnnealingLR : public LRScheduler {
+ public:
+  /**
+   * @param nSteps The number of steps of the annealing
+   * @param minRate The learning rate at the end of the annealing
+   * @param perBatch Whether the steps are batches (otherwise epochs)
+   */
+  CosineAnnealingLR(int nSteps, double minRate = 0, bool perBatch = true)
+      : LRScheduler(perBatch), nSteps(nSteps), minRate(minRate) {
+    if (nSteps <= 0)
+      throw std::invalid_argument("The number of steps must be positive");
+  };
+
+  double getRate(int step, double baseRate) const override {
+    const double progress =
+        std::min(step, nSteps) / static_cast<double>(nSteps);
+    return minRate + (baseRate - minRate) * (1 + std::cos(pi * progress)) / 2;
+  }
+
+ private:
+  static constexpr double pi = 3.14159265358979323846;
+
+  int nSteps;
+  double minRate;
+};
+}  // namespace NeuralNet
@@ -0,0 +1,55 @@
+#pragma once
+
+namespace NeuralNet {
+/**
+ * Learning rate schedule, the mini-batch training sets the optimizer's
+ * learning rate from it at every batch or at every epoch (see
+ * `Network::setScheduler`).
+ *
+ * The schedule starts over at every training, from the learning rate the
+ * optimizer was created with (the base rate), which the optimizer gets back
+ * once the training is over.
+ */
+class LRScheduler {
+ public:
+  /**
+   * @param perBatch Whether the learning rate changes at every batch
+   * (otherwise at every epoch)
+   */
+  explicit LRScheduler(bool perBatch) : perBatch(perBatch){};
+
+  virtual ~LRScheduler() = default;
+
+  /**
+   * @brief Get the learning rate of a step of the training
+   *
+   * @param step The number of batches (or epochs) since the training began
+   * @param baseRate The learning rate of the optimizer
+   *
+   * @return The learning rate of the step
+   */
+  virtual double getRate(int step, double baseRate) const = 0;
+
+  /**
+   * @brief Records the loss of an epoch (ex: to reduce the learning rate once
+   * it stops improving)
+   *
+   * @param loss The loss of the epoch (the test loss when there's test data)
+   */
+  virtual void onEpochEnd(double /*loss*/){};
+
+  /**
+   * @brief Clears the state of the schedule, called when a training begins
+   */
+  virtual void reset(){};
+
+  /**
+   * @brief Whether the learning rate changes at every batch (otherwise at
+   * every epoch)
+   */
+  bool isPerBatch() const { return perBatch; }
+
+ protected:
+  bool perBatch;
+};
+}  // namespace NeuralNet
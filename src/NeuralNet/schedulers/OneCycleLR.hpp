@@ -0,0 +1,58 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "LRScheduler.hpp"
+
+namespace NeuralNet {
+/**
+ * One-cycle policy (Smith & Topin, "Super-Convergence"), the learning rate
+ * rises from `maxRate / divFactor` to `maxRate` then anneals to
+ * `maxRate / (divFactor * finalDivFactor)`, both along half cosines. The base
+ * rate of the optimizer isn't used.
+ */
+class OneCycleLR : public LRScheduler {
+ public:
+  /**
+   * @param maxRate The peak learning rate
+   * @param nSteps The number of steps (batches) of the cycle
+   * @param pctStart The fraction of the cycle spent rising
+   * @param divFactor The ratio between the peak and the initial rate
+   * @param finalDivFactor The ratio between the initial and the final rate
+   */
+  OneCycleLR(double maxRate, int nSteps, double pctStart = 0.3,
+             double divFactor = 25, double finalDivFactor = 1e4)
+      : LRScheduler(true),
+        maxRate(maxRate),
+        initialRate(maxRate / divFactor),
+        finalRate(maxRate / divFactor / finalDivFactor),
+        nSteps(nSteps),
+        nRisingSteps(std::max(1.0, pctStart * nSteps)) {
+    if (nSteps <= 1)
+      throw std::invalid_argument("The cycle must last more than one step");
+    if (pctStart <= 0 || pctStart >= 1)
+      throw std::invalid_argument("pctStart must be in (0, 1)");
+  };
+
+  double getRate(int step, double /*baseRate*/) const override {
+    if (step < nRisingSteps)
+      return anneal(initialRate, maxRate, step / nRisingSteps);
+
+    const double progress = (step - nRisingSteps) / (nSteps - nRisingSteps);
+    return anneal(maxRate, finalRate, std::min(progress, 1.0));
+  }
+
+ private:
+  static constexpr double pi = 3.14159265358979323846;
+
+  double maxRate, initialRate, finalRate;
+  int nSteps;
+  double nRisingSteps;
+
+  static double anneal(double from, double to, double progress) {
+    return to + (from - to) * (1 + std::cos(pi * progress)) / 2;
+  }
+};
+}  // namespace NeuralNet
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "LRScheduler.hpp"
+
+namespace NeuralNet {
+/**
+ * Reduces the learning rate once the loss stops improving, the rate changes
+ * at the end of the epochs
+ */
+class ReduceLROnPlateau : public LRScheduler {
+ public:
+  /**
+   * @param factor The factor applied to the learning rate at each reduction
+   * @param patience The number of epochs without improvement after which the
+   * learning rate is reduced
+   * @param minDelta The minimum decrease of the loss that counts as an
+   * improvement
+   * @param minRate The lower bound of the learning rate
+   */
+  ReduceLROnPlateau(double factor = 0.1, int patience = 10,
+                    double minDelta = 1e-4, double minRate = 0)
+      : LRScheduler(false),
+        factor(factor),
+        patience(patience),
+        minDelta(minDelta),
+        minRate(minRate) {
+    if (factor <= 0 || factor >= 1)
+      throw std::invalid_argument("The factor must be in (0, 1)");
+  };
+
+  double getRate(int /*step*/, double baseRate) const override {
+    return std::max(baseRate * scale, minRate);
+  }
+
+  void onEpochEnd(double loss) override {
+    if (loss < bestLoss - minDelta) {
+      bestLoss = loss;
+      wait = 0;
+    } else if (++wait > patience) {
+      scale *= factor;
+      wait = 0;
+    }
+  }
+
+  void reset() override {
+    bestLoss = std::numeric_limits<double>::infinity();
+    wait = 0;
+    scale = 1;
+  }
+
+ private:
+  double factor;
+  int patience;
+  double minDelta, minRate;
+  double bestLoss = std::numeric_limits<double>::infinity();
+  int wait = 0;  // Epochs since the last improvement
+  double scale = 1;  // Product of the reductions
+};
+}  // namespace NeuralNet
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cmath>
+#include <stdexcept>
+
+#include "LRScheduler.hpp"
+
+namespace NeuralNet {
+/**
+ * Decays the learning rate by a constant factor every `stepSize` steps
+ */
+class StepLR : public LRScheduler {
+ public:
+  /**
+   * @param stepSize The number of steps between two decays
+   * @param gamma The decay factor
+   * @param perBatch Whether the steps are batches (otherwise epochs)
+   */
+  StepLR(int stepSize, double gamma = 0.1, bool perBatch = false)
+      : LRScheduler(perBatch), stepSize(stepSize), gamma(gamma) {
+    if (stepSize <= 0)
+      throw std::invalid_argument("The step size must be positive");
+  };
+
+  double getRate(int step, double baseRate) const override {
+    return baseRate * std::pow(gamma, step / stepSize);
+  }
+
+ private:
+  int stepSize;
+  double gamma;
+};
+}  // namespace NeuralNet
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+
+#include "LRScheduler.hpp"
+
+namespace NeuralNet {
+/**
+ * Raises the learning rate linearly up to the base rate during the first
+ * steps, then hands over to another schedule (ex: warmup then cosine decay
+ * to train with large batches)
+ */
+class WarmupLR : public LRScheduler {
+ public:
+  /**
+   * @param warmupSteps The number of steps of the warmup
+   * @param after The schedule that follows the warmup, its steps are counted
+   * from the end of the warmup in the same unit (none to keep the base rate)
+   * @param perBatch Whether the steps are batches (otherwise epochs)
+   */
+  WarmupLR(int warmupSteps, std::shared_ptr<LRScheduler> after = nullptr,
+           bool perBatch = true)
+      : LRScheduler(perBatch), warmupSteps(warmupSteps), after(after) {
+    if (warmupSteps <= 0)
+      throw std::invalid_argument("The warmup must last at least one step");
+  };
+
+  double getRate(int step, double baseRate) const override {
+    if (step < warmupSteps) return baseRate * (step + 1) / warmupSteps;
+    return after ? after->getRate(step - warmupSteps, baseRate) : baseRate;
+  }
+
+  void onEpochEnd(double loss) override {
+    if (after) after->onEpochEnd(loss);
+  }
+
+  void reset() override {
+    if (after) after->reset();
+  }
+
+ private:
+  int warmupSteps;
+  std::shared_ptr<LRScheduler> after;
+};
+}  // namespace NeuralNet
@@ -0,0 +1,12 @@
+/**
+ * The purpose of this file is solely to group the includes of the files in this
+ * folder.
+ */
+#pragma once
+
+#include "CosineAnnealingLR.hpp"
+#include "LRScheduler.hpp"
+#include "OneCycleLR.hpp"
+#include "ReduceLROnPlateau.hpp"
+#include "StepLR.hpp"
+#include "WarmupLR.hpp"
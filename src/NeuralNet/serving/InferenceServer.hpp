@@ -0,0 +1,619 @@
+#pragma once
+
+#ifdef _WIN32
+#error "The inference server relies on POSIX sockets"
+#endif
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "InferenceSession.hpp"
+
+namespace NeuralNet {
+/**
+ * Wire format shared by the `InferenceServer` and the `InferenceClient`.
+ *
+ * Over a stream socket (native byte order), a request is :
+ *  - a `RequestHeader` (number of samples and of values per sample)
+ *  - the samples as float32, contiguous and row-major
+ *
+ * And its response :
+ *  - a `ResponseHeader` (status, number of samples and of outputs per sample)
+ *  - the outputs as float32, contiguous and row-major (if the status is OK)
+ *
+ * Several requests can be sent one after the other on a connection. The
+ * server closes the connection after answering an invalid request.
+ */
+namespace wire {
+struct RequestHeader {
+  uint32_t rows = 0;
+  uint32_t cols = 0;
+};
+
+struct ResponseHeader {
+  uint32_t status = 0;  // 0 : OK, 1 : invalid request
+  uint32_t rows = 0;
+  uint32_t cols = 0;
+};
+
+/**
+ * @brief Reads exactly `size` bytes (false if the connection was closed)
+ */
+inline bool readAll(int fd, void *buffer, size_t size) {
+  char *data = static_cast<char *>(buffer);
+  while (size > 0) {
+    const ssize_t n = ::read(fd, data, size);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+
+/**
+ * @brief Writes exactly `size` bytes (false if the connection was closed)
+ */
+inline bool writeAll(int fd, const void *buffer, size_t size) {
+#ifdef MSG_NOSIGNAL
+  const int flags = MSG_NOSIGNAL;  // No SIGPIPE when the peer has left
+#else
+  const int flags = 0;
+#endif
+  const char *data = static_cast<const char *>(buffer);
+  while (size > 0) {
+    const ssize_t n = ::send(fd, data, size, flags);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data += n;
+    size -= n;
+  }
+  return true;
+}
+}  // namespace wire
+
+/**
+ * Inference server listening on a Unix domain socket or on a localhost TCP
+ * port.
+ *
+ * The concurrent requests are coalesced into batches (up to `maxBatchSize`
+ * samples, waiting at most `maxWait` for more requests after the first one),
+ * each batch goes through a single forward pass and the outputs are scattered
+ * back to the requests. A request's float32 samples are kept as received
+ * until the batcher converts them into the batch's matrix, and the outputs
+ * are converted back to float32 straight out of the forward pass.
+ *
+ * The server only reads the network (see `InferenceSession`), which mustn't
+ * be trained while it's running.
+ */
+class InferenceServer {
+ public:
+  /**
+   * Counters of the served requests
+   */
+  struct Stats {
+    uint64_t nRequests = 0;
+    uint64_t nSamples = 0;
+    uint64_t nBatches = 0;
+    double p50 = 0;  // Median latency (microseconds)
+    double p99 = 0;  // 99th percentile latency (microseconds)
+    double requestsPerSecond = 0;  // Since the server started
+    double samplesPerSecond = 0;
+  };
+
+  /**
+   * @param network The network to serve, it must outlive the server
+   * @param maxBatchSize The maximum number of samples of a batch (a larger
+   * request is served as its own batch)
+   * @param maxWait The maximum time a request waits for others to be batched
+   * with
+   */
+  InferenceServer(
+      const Network &network, int maxBatchSize = 32,
+      std::chrono::microseconds maxWait = std::chrono::microseconds(1000))
+      : network(network),
+        session(network),
+        maxBatchSize(std::max(maxBatchSize, 1)),
+        maxWait(maxWait) {
+    latencies.reserve(maxLatencies);
+  };
+
+  ~InferenceServer() { stop(); };
+
+  InferenceServer(const InferenceServer &) = delete;
+  InferenceServer &operator=(const InferenceServer &) = delete;
+
+  /**
+   * @brief Listens on a Unix domain socket (an existing socket at the path is
+   * replaced)
+   *
+   * @param path The path of the socket
+   *
+   * @throw std::runtime_error When a file that isn't a socket exists at the
+   * path
+   */
+  void listenUnix(const std::string &path) {
+    if (listenFd >= 0)
+      throw std::runtime_error("The inference server is already listening");
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+      throw std::runtime_error("Socket path too long : " + path);
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // Only a stale socket is removed, never another file
+    struct stat status;
+    if (::lstat(path.c_str(), &status) == 0) {
+      if (!S_ISSOCK(status.st_mode))
+        throw std::runtime_error("Not a socket : " + path);
+      ::unlink(path.c_str());
+    }
+    openListener(AF_UNIX, reinterpret_cast<sockaddr *>(&address),
+                 sizeof(address));
+    unixPath = path;
+  }
+
+  /**
+   * @brief Listens on a localhost (127.0.0.1) TCP port
+   *
+   * @param port The port (0 to pick any free port, see `getPort`)
+   */
+  void listenTcp(int port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    openListener(AF_INET, reinterpret_cast<sockaddr *>(&address),
+                 sizeof(address));
+
+    socklen_t size = sizeof(address);
+    getsockname(listenFd, reinterpret_cast<sockaddr *>(&address), &size);
+    this->port = ntohs(address.sin_port);
+  }
+
+  /**
+   * @brief Get the TCP port the server listens on (0 if not listening on TCP)
+   */
+  int getPort() const { return port; }
+
+  /**
+   * @brief Starts accepting connections and serving requests in the
+   * background
+   */
+  void start() {
+    if (listenFd < 0)
+      throw std::runtime_error("The inference server isn't listening");
+    if (running) return;
+
+    running = true;
+    startTime = std::chrono::steady_clock::now();
+    batcher = std::thread(&InferenceServer::batchLoop, this);
+    acceptor = std::thread(&InferenceServer::acceptLoop, this);
+  }
+
+  /**
+   * @brief Stops the server, the pending requests are still answered. The
+   * listener is closed even if the server wasn't started.
+   */
+  void stop() {
+    bool wasRunning;
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      wasRunning = running;
+      running = false;
+    }
+
+    if (wasRunning) {
+      cvQueue.notify_all();
+      if (acceptor.joinable()) acceptor.join();
+      if (batcher.joinable()) batcher.join();
+
+      {
+        std::lock_guard<std::mutex> lock(connectionsMtx);
+        for (int fd : connectionFds) ::shutdown(fd, SHUT_RDWR);
+      }
+      for (std::thread &connection : connections) connection.join();
+      connections.clear();
+      finishedConnections.clear();
+    }
+
+    if (listenFd >= 0) ::close(listenFd);
+    listenFd = -1;
+    if (!unixPath.empty()) ::unlink(unixPath.c_str());
+    unixPath.clear();
+    port = 0;
+  }
+
+  /**
+   * @brief Get the counters of the requests served so far
+   *
+   * @note The latencies percentiles are computed over the last 100K requests
+   */
+  Stats getStats() const {
+    std::lock_guard<std::mutex> lock(statsMtx);
+    Stats current = stats;
+
+    if (!latencies.empty()) {
+      std::vector<double> sorted = latencies;
+      std::sort(sorted.begin(), sorted.end());
+      current.p50 = sorted[(sorted.size() - 1) / 2];
+      current.p99 = sorted[(sorted.size() - 1) * 99 / 100];
+    }
+
+    const double elapsed =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                      startTime)
+            .count();
+    if (elapsed > 0) {
+      current.requestsPerSecond = stats.nRequests / elapsed;
+      current.samplesPerSecond = stats.nSamples / elapsed;
+    }
+
+    return current;
+  }
+
+ private:
+  using RowMatrixXf =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  /**
+   * A request waiting for its outputs
+   */
+  struct Request {
+    std::vector<float> inputs;  // As received, row-major
+    int rows = 0;
+    RowMatrixXf outputs;
+    std::chrono::steady_clock::time_point arrival;
+    bool done = false;
+  };
+
+  static constexpr size_t maxLatencies = 100000;
+  static constexpr uint32_t maxRequestRows = 1 << 16;
+
+  const Network &network;
+  InferenceSession session;  // Only used by the batcher thread
+  int maxBatchSize;
+  std::chrono::microseconds maxWait;
+  int listenFd = -1, port = 0;
+  std::string unixPath;
+  bool running = false;
+  std::chrono::steady_clock::time_point startTime;
+
+  std::thread acceptor, batcher;
+  std::vector<std::thread> connections;
+  std::vector<int> connectionFds;
+  std::vector<std::thread::id> finishedConnections;  // Not joined yet
+  std::mutex connectionsMtx;
+
+  std::deque<Request *> queue;  // Requests waiting to be batched
+  std::mutex mtx;
+  std::condition_variable cvQueue, cvDone;
+
+  Stats stats;
+  std::vector<double> latencies;  // Ring buffer of the last latencies (us)
+  size_t nextLatency = 0;
+  mutable std::mutex statsMtx;
+
+  Matrix batch;  // Inputs of the current batch
+
+  void openListener(int family, const sockaddr *address, socklen_t size) {
+    if (listenFd >= 0)
+      throw std::runtime_error("The inference server is already listening");
+
+    listenFd = ::socket(family, SOCK_STREAM, 0);
+    if (listenFd < 0) throw std::runtime_error("Couldn't create the socket");
+
+    const int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    if (::bind(listenFd, address, size) != 0 || ::listen(listenFd, 64) != 0) {
+      ::close(listenFd);
+      listenFd = -1;
+      throw std::runtime_error("Couldn't listen : " +
+                               std::string(std::strerror(errno)));
+    }
+  }
+
+  bool isRunning() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return running;
+  }
+
+  /**
+   * Accepts the connections, each one is served by its own thread
+   */
+  void acceptLoop() {
+    pollfd listener{listenFd, POLLIN, 0};
+
+    while (isRunning()) {
+      joinFinishedConnections();
+
+      // Waking up regularly to notice when the server stops
+      if (::poll(&listener, 1, 50) <= 0) continue;
+
+      const int fd = ::accept(listenFd, nullptr, nullptr);
+      if (fd < 0) continue;
+
+      std::lock_guard<std::mutex> lock(connectionsMtx);
+      connectionFds.push_back(fd);
+      connections.emplace_back(&InferenceServer::serveConnection, this, fd);
+    }
+  }
+
+  /**
+   * Joins the threads of the closed connections, so that a long running
+   * server only keeps the threads of the open ones
+   */
+  void joinFinishedConnections() {
+    std::lock_guard<std::mutex> lock(connectionsMtx);
+
+    for (std::thread::id id : finishedConnections) {
+      auto connection =
+          std::find_if(connections.begin(), connections.end(),
+                       [id](const std::thread &t) { return t.get_id() == id; });
+      connection->join();  // It's returning
+      connections.erase(connection);
+    }
+    finishedConnections.clear();
+  }
+
+  /**
+   * Reads the requests of a connection, waits for their outputs and writes
+   * them back. The connection is closed after an invalid request or an error
+   * (ex: a failed allocation), the other connections aren't affected.
+   */
+  void serveConnection(int fd) {
+    try {
+      serveRequests(fd);
+    } catch (...) {
+    }
+
+    std::lock_guard<std::mutex> lock(connectionsMtx);
+    connectionFds.erase(
+        std::find(connectionFds.begin(), connectionFds.end(), fd));
+    ::close(fd);
+    finishedConnections.push_back(std::this_thread::get_id());
+  }
+
+  void serveRequests(int fd) {
+    const uint32_t nInputs = network.getLayer(0)->getNumNeurons();
+    Request request;
+    wire::RequestHeader header;
+
+    while (wire::readAll(fd, &header, sizeof(header))) {
+      wire::ResponseHeader response;
+
+      // Checked before anything is allocated from the header, the rest of
+      // the request is left unread
+      if (header.rows == 0 || header.rows > maxRequestRows ||
+          header.cols != nInputs) {
+        response.status = 1;
+        wire::writeAll(fd, &response, sizeof(response));
+        return;
+      }
+
+      request.inputs.resize(static_cast<size_t>(header.rows) * header.cols);
+      if (!wire::readAll(fd, request.inputs.data(),
+                         request.inputs.size() * sizeof(float)))
+        return;
+
+      request.rows = header.rows;
+      request.arrival = std::chrono::steady_clock::now();
+      request.done = false;
+
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        if (!running) return;  // The batcher might be gone already
+        queue.push_back(&request);
+        cvQueue.notify_one();
+        cvDone.wait(lock, [&request] { return request.done; });
+      }
+
+      response.rows = request.outputs.rows();
+      response.cols = request.outputs.cols();
+
+      if (!wire::writeAll(fd, &response, sizeof(response)) ||
+          !wire::writeAll(fd, request.outputs.data(),
+                          request.outputs.size() * sizeof(float)))
+        return;
+    }
+  }
+
+  /**
+   * Coalesces the queued requests into batches and runs them through the
+   * network
+   */
+  void batchLoop() {
+    std::vector<Request *> batched;
+
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mtx);
+        cvQueue.wait(lock, [this] { return !running || !queue.empty(); });
+        if (queue.empty()) return;  // Stopped and nothing left to serve
+
+        // Waiting for more requests, until the batch is full or the first
+        // request has waited long enough
+        const auto deadline = queue.front()->arrival + maxWait;
+        while (running && queuedSamples() < maxBatchSize &&
+               cvQueue.wait_until(lock, deadline) !=
+                   std::cv_status::timeout) {
+        }
+
+        int nSamples = 0;
+        batched.clear();
+        while (!queue.empty() &&
+               (batched.empty() ||
+                nSamples + queue.front()->rows <= maxBatchSize)) {
+          nSamples += queue.front()->rows;
+          batched.push_back(queue.front());
+          queue.pop_front();
+        }
+      }
+
+      runBatch(batched);
+
+      {
+        std::lock_guard<std::mutex> lock(mtx);
+        for (Request *request : batched) request->done = true;
+      }
+      cvDone.notify_all();
+    }
+  }
+
+  int queuedSamples() const {
+    int nSamples = 0;
+    for (const Request *request : queue) nSamples += request->rows;
+    return nSamples;
+  }
+
+  /**
+   * Gathers the requests' samples, runs the forward pass and scatters the
+   * outputs
+   */
+  void runBatch(const std::vector<Request *> &batched) {
+    const int nInputs = network.getLayer(0)->getNumNeurons();
+    int nSamples = 0;
+    for (const Request *request : batched) nSamples += request->rows;
+
+    batch.resize(nSamples, nInputs);
+    int r = 0;
+    for (const Request *request : batched) {
+      batch.middleRows(r, request->rows) =
+          Eigen::Map<const RowMatrixXf>(request->inputs.data(), request->rows,
+                                        nInputs)
+              .cast<Scalar>();
+      r += request->rows;
+    }
+
+    const Matrix &outputs = session.predict(batch);
+
+    r = 0;
+    for (Request *request : batched) {
+      request->outputs = outputs.middleRows(r, request->rows).cast<float>();
+      r += request->rows;
+    }
+
+    // Recording the latencies
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(statsMtx);
+    stats.nBatches++;
+    stats.nSamples += nSamples;
+
+    for (const Request *request : batched) {
+      const double latency = std::chrono::duration<double, std::micro>(
+                                 now - request->arrival)
+                                 .count();
+      stats.nRequests++;
+      if (latencies.size() < maxLatencies) {
+        latencies.push_back(latency);
+      } else {
+        latencies[nextLatency] = latency;
+        nextLatency = (nextLatency + 1) % maxLatencies;
+      }
+    }
+  }
+};
+
+/**
+ * Blocking client of an `InferenceServer`
+ */
+class InferenceClient {
+ public:
+  InferenceClient() = default;
+
+  ~InferenceClient() {
+    if (fd >= 0) ::close(fd);
+  };
+
+  InferenceClient(const InferenceClient &) = delete;
+  InferenceClient &operator=(const InferenceClient &) = delete;
+
+  /**
+   * @brief Connects to a server listening on a Unix domain socket
+   *
+   * @param path The path of the socket
+   */
+  void connectUnix(const std::string &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    open(AF_UNIX, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+  }
+
+  /**
+   * @brief Connects to a server listening on a localhost TCP port
+   *
+   * @param port The port of the server
+   */
+  void connectTcp(int port) {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    open(AF_INET, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+  }
+
+  /**
+   * @brief Sends the samples to the server and waits for the outputs
+   *
+   * @param inputs The inputs, one (flattened) sample per row
+   *
+   * @return The outputs of the network
+   */
+  Matrix predict(const Matrix &inputs) {
+    using RowMatrixXf =
+        Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    wire::RequestHeader header;
+    header.rows = inputs.rows();
+    header.cols = inputs.cols();
+    RowMatrixXf values = inputs.cast<float>();
+
+    if (!wire::writeAll(fd, &header, sizeof(header)) ||
+        !wire::writeAll(fd, values.data(), values.size() * sizeof(float)))
+      throw std::runtime_error("Couldn't send the request");
+
+    wire::ResponseHeader response;
+    if (!wire::readAll(fd, &response, sizeof(response)))
+      throw std::runtime_error("Couldn't read the response");
+    if (response.status != 0) throw std::runtime_error("Invalid request");
+
+    values.resize(response.rows, response.cols);
+    if (!wire::readAll(fd, values.data(), values.size() * sizeof(float)))
+      throw std::runtime_error("Couldn't read the response");
+
+    return values.cast<Scalar>();
+  }
+
+ private:
+  int fd = -1;
+
+  void open(int family, const sockaddr *address, socklen_t size) {
+    fd = ::socket(family, SOCK_STREAM, 0);
+    if (fd < 0 || ::connect(fd, address, size) != 0)
+      throw std::runtime_error("Couldn't connect to the inference server");
+  }
+};
+}  // namespace NeuralNet
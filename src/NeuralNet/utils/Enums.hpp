@@ -20,4 +20,21 @@ enum class LOSS {
   QUADRATIC,
   BCE  // Binary Cross-Entropy
 };
+
+enum class TRAINING_MODE {
+  SEQUENTIAL,
+  DATA_PARALLEL,  // Mini-batches split across worker threads
+  HOGWILD  // Lock-free asynchronous SGD, one mini-batch per worker thread
+};
+
+enum class UPDATE_SCHEDULE {
+  PER_LAYER,  // Each layer is updated as soon as its gradients are computed
+  AFTER_BACKPROP  // A single step for all the layers, split across threads
+};
+
+enum class DTYPE {
+  FLOAT32,
+  UINT8,  // Raw bytes (ex: pixels)
+  FLOAT64
+};
 }  // namespace NeuralNet
@@ -18,8 +18,7 @@ namespace NeuralNet {
  * @return The resulting matrix from the passed labels
  */
 template <typename T>
-static Eigen::MatrixXd formatLabels(std::vector<T> labels,
-                                    std::tuple<int, int> shape) {
+static Matrix formatLabels(std::vector<T> labels, std::tuple<int, int> shape) {
   int rows = std::get<0>(shape);
   int cols = std::get<1>(shape);
 
@@ -27,13 +26,14 @@ static Eigen::MatrixXd formatLabels(std::vector<T> labels,
   assert(labels.size() == rows &&
          "The number of labels don't match the number of inputs");
 
-  Eigen::MatrixXd mLabels(rows, cols);
+  Matrix mLabels(rows, cols);
 
   if constexpr (std::is_same<T, std::vector<double>>::value) {
     std::vector<double> flattenedVector = flatten2DVector(labels, rows, cols);
-    mLabels = Eigen::Map<Eigen::MatrixXd>(flattenedVector.data(), rows, cols);
+    mLabels = Eigen::Map<Eigen::MatrixXd>(flattenedVector.data(), rows, cols)
+                  .cast<Scalar>();
   } else if constexpr (std::is_same<T, double>::value) {
-    mLabels = Eigen::MatrixXd::Zero(rows, cols);
+    mLabels = Matrix::Zero(rows, cols);
 
     /**
      * Setting the cols indexes to 1
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <filesystem>
@@ -8,6 +9,9 @@
 #include <iostream>
 #include <random>
 
+#include "Random.hpp"
+#include "Types.hpp"
+
 namespace fs = std::filesystem;
 
 namespace NeuralNet {
@@ -22,8 +26,8 @@ namespace NeuralNet {
  */
 inline double mtRand(double min, double max) {
   assert(min < max);
-  std::random_device rseed;
-  std::mt19937_64 rng(rseed());
+  // Seeded once per thread, not at every call
+  thread_local std::mt19937_64 rng(std::random_device{}());
   std::uniform_real_distribution<double> dist(min, max);
 
   return dist(rng);
@@ -170,9 +174,9 @@ inline void reserve2d(std::vector<std::vector<T>> &v, int rows, int cols) {
  * @return -1 if an error occurs or not found otherwise returns the row index of
  * the element.
  */
-inline int findRowIndexOfMaxEl(const Eigen::MatrixXd &m) {
+inline int findRowIndexOfMaxEl(const Matrix &m) {
   // Find the maximum value in the matrix
-  double maxVal = m.maxCoeff();
+  Scalar maxVal = m.maxCoeff();
 
   // Find the row index by iterating through rows
   for (int i = 0; i < m.rows(); ++i) {
@@ -236,71 +240,55 @@ inline int findIndexOf(const std::vector<T> &v, const T &el) {
 }
 
 /* MATRIX OPERATIONS */
-inline Eigen::MatrixXd zeroMatrix(const std::tuple<int, int> size) {
-  return Eigen::MatrixXd::Zero(std::get<0>(size), std::get<1>(size));
+inline Matrix zeroMatrix(const std::tuple<int, int> size) {
+  return Matrix::Zero(std::get<0>(size), std::get<1>(size));
 }
 
-inline Eigen::MatrixXd vectorToMatrixXd(std::vector<std::vector<double>> &v) {
-  if (v.empty() || v[0].empty()) return Eigen::MatrixXd(0, 0);
+inline Matrix vectorToMatrixXd(const std::vector<std::vector<double>> &v) {
+  if (v.empty() || v[0].empty()) return Matrix(0, 0);
 
   int rows = v.size();
   int cols = v[0].size();
 
-  // Flatten the vector of vectors into a single vector
-  std::vector<double> flat;
-  flat.reserve(rows * cols);
-  for (const auto &row : v) {
-    flat.insert(flat.end(), row.begin(), row.end());
+  // Copying the rows straight into the matrix
+  Matrix m(rows, cols);
+  for (int r = 0; r < rows; r++) {
+    assert(v[r].size() == static_cast<size_t>(cols));
+    m.row(r) = Eigen::RowVectorXd::Map(v[r].data(), cols).cast<Scalar>();
   }
 
-  return Eigen::Map<
-      Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
-      flat.data(), rows, cols);
+  return m;
 };
 
 /**
  * @brief initialises a matrix with random values that ranges between the
  * defined boundaries
  *
- * @param weightsMatrix a pointer to the weights matrix or any Eigen::MatrixXd
+ * @param weightsMatrix a pointer to the weights matrix or any Matrix
  * @param min The min value in the range (default: -1)
  * @param max The max value in the range (default: 1)
  *
  * @return void
  */
-static void randomWeightInit(Eigen::MatrixXd *weightsMatrix, double min = -1.0,
+inline void randomWeightInit(Matrix *weightsMatrix, double min = -1.0,
                              double max = 1.0) {
-  for (int col = 0; col < weightsMatrix->cols(); col++) {
-    for (int row = 0; row < weightsMatrix->rows(); row++) {
-      weightsMatrix->operator()(row, col) = mtRand(min, max);
-    }
-  }
-
-  return;
+  Philox generator = randomGenerator();
+  fillUniform(*weightsMatrix, generator, min, max);
 };
 
 /**
  * @brief Method that sets the value of a matrix to follow a certain random Dist
  *
- * @param weightsMatrix A pointer to a weight matrix or any Eigen::MatrixXd
+ * @param weightsMatrix A pointer to a weight matrix or any Matrix
  * @param mean The mean for the std dist
  * @param stddev The standard deviation
  *
  * @return void
  */
-static void randomDistMatrixInit(Eigen::MatrixXd *weightsMatrix, double mean,
+inline void randomDistMatrixInit(Matrix *weightsMatrix, double mean,
                                  double stddev) {
-  std::random_device rseed;
-  std::default_random_engine generator(rseed());
-  std::normal_distribution<double> distribution(mean, stddev);
-
-  for (int col = 0; col < weightsMatrix->cols(); col++) {
-    for (int row = 0; row < weightsMatrix->rows(); row++) {
-      weightsMatrix->operator()(row, col) = distribution(generator);
-    }
-  }
-
-  return;
+  Philox generator = randomGenerator();
+  fillNormal(*weightsMatrix, generator, mean, stddev);
 };
 
 /**
@@ -310,8 +298,8 @@ static void randomDistMatrixInit(Eigen::MatrixXd *weightsMatrix, double mean,
  *
  * @return the hardmax version of the matrix.
  */
-static Eigen::MatrixXd hardmax(const Eigen::MatrixXd &mat) {
-  Eigen::MatrixXd hardmaxMatrix = Eigen::MatrixXd::Zero(mat.rows(), mat.cols());
+inline Matrix hardmax(const Matrix &mat) {
+  Matrix hardmaxMatrix = Matrix::Zero(mat.rows(), mat.cols());
 
   for (int i = 0; i < mat.rows(); ++i) {
     int maxIndex;
@@ -332,8 +320,7 @@ static Eigen::MatrixXd hardmax(const Eigen::MatrixXd &mat) {
  *
  * @return the same matrix with the values < threshold = 0
  */
-static Eigen::MatrixXd trim(const Eigen::MatrixXd &logits,
-                            double threshold = 0.01) {
+static Matrix trim(const Matrix &logits, Scalar threshold = 0.01) {
   return (logits.array() < threshold).select(0, logits);
 }
 
@@ -345,8 +332,7 @@ static Eigen::MatrixXd trim(const Eigen::MatrixXd &logits,
  *
  * @return the same matrix with the values < threshold = threshold
  */
-static Eigen::MatrixXd thresh(const Eigen::MatrixXd &logits,
-                              double threshold = 0.01) {
+inline Matrix thresh(const Matrix &logits, Scalar threshold = 0.01) {
   return (logits.array() < threshold).select(threshold, logits);
 }
 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Types.hpp"
+
+namespace NeuralNet {
+// View of a block of parameters (or of their gradients) in an arena
+using ParameterMap = Eigen::Map<Matrix, Eigen::AlignedMax>;
+using ConstParameterMap = Eigen::Map<const Matrix, Eigen::AlignedMax>;
+
+// View of all the parameters (or all the gradients) of an arena
+using FlatParameterMap =
+    Eigen::Map<Eigen::Matrix<Scalar, Eigen::Dynamic, 1>, Eigen::AlignedMax>;
+
+// Aligned scalars (ex: a worker's gradients, laid out like an arena's)
+using AlignedBuffer = std::vector<Scalar, Eigen::aligned_allocator<Scalar>>;
+
+/**
+ * One contiguous, aligned buffer holding all the trainable parameters of a
+ * network, followed by their gradients laid out the same way.
+ *
+ * The layers view their blocks (ex: a Dense layer's weights and biases) with
+ * `ParameterMap`s. The whole set of parameters or gradients is a single
+ * vector : an element-wise optimizer step is one sweep over it and summing
+ * the gradients of several workers is a sum of flat buffers.
+ *
+ * Every block starts on a 64 bytes boundary (the padding stays at 0), so the
+ * views are aligned for any SIMD instruction set.
+ */
+class ParameterArena {
+ public:
+  /**
+   * @param size The number of scalars of the arena (see `blockSize`)
+   */
+  explicit ParameterArena(size_t size)
+      : size(size), buffer(2 * size + alignment, 0) {
+    // Skipping the scalars before the first 64 bytes boundary
+    const uintptr_t address = reinterpret_cast<uintptr_t>(buffer.data());
+    const size_t misalignment = address % (alignment * sizeof(Scalar));
+    base = buffer.data() +
+           (misalignment ? alignment - misalignment / sizeof(Scalar) : 0);
+  };
+
+  // The views point into the buffer
+  ParameterArena(const ParameterArena &) = delete;
+  ParameterArena &operator=(const ParameterArena &) = delete;
+
+  /**
+   * @brief Get the number of scalars reserved by a block of the given shape,
+   * padded to keep the next block aligned
+   */
+  static size_t blockSize(Eigen::Index rows, Eigen::Index cols) {
+    const size_t n = static_cast<size_t>(rows * cols);
+    return (n + alignment - 1) / alignment * alignment;
+  }
+
+  /**
+   * @brief Get the number of scalars of the parameters (as many for the
+   * gradients)
+   */
+  size_t getSize() const { return size; }
+
+  Scalar *parameters() { return base; }
+  const Scalar *parameters() const { return base; }
+  Scalar *gradients() { return base + size; }
+  const Scalar *gradients() const { return base + size; }
+
+  /**
+   * @brief View of a block of parameters
+   *
+   * @param offset The offset of the block (a sum of `blockSize`s)
+   * @param rows The number of rows of the block
+   * @param cols The number of columns of the block
+   */
+  ParameterMap parameters(size_t offset, Eigen::Index rows, Eigen::Index cols) {
+    assert(offset + rows * cols <= size);
+    return ParameterMap(parameters() + offset, rows, cols);
+  }
+
+  /**
+   * @brief View of the gradients of a block of parameters
+   */
+  ParameterMap gradients(size_t offset, Eigen::Index rows, Eigen::Index cols) {
+    assert(offset + rows * cols <= size);
+    return ParameterMap(gradients() + offset, rows, cols);
+  }
+
+  /**
+   * @brief View of all the parameters
+   */
+  FlatParameterMap flatParameters() {
+    return FlatParameterMap(parameters(), size);
+  }
+
+  /**
+   * @brief View of all the gradients
+   */
+  FlatParameterMap flatGradients() {
+    return FlatParameterMap(gradients(), size);
+  }
+
+ private:
+  static constexpr size_t alignment = 64 / sizeof(Scalar);  // In scalars
+
+  size_t size;
+  AlignedBuffer buffer;
+  Scalar *base;  // Parameters then gradients, on a 64 bytes boundary
+};
+}  // namespace NeuralNet
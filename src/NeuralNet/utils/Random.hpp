@@ -0,0 +1,323 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "Types.hpp"
+#include "WorkerPool.hpp"
+
+namespace NeuralNet {
+namespace detail {
+/**
+ * Threads shared by the large fills, started on the first one
+ */
+struct FillPool {
+  WorkerPool pool{
+      static_cast<int>(std::max(1u, std::thread::hardware_concurrency()))};
+  std::mutex mtx;  // Held by the fill using the pool
+};
+
+inline FillPool &fillPool() {
+  static FillPool shared;
+  return shared;
+}
+}  // namespace detail
+
+/**
+ * Counter-based random generator (Philox4x32-10, Salmon et al. "Parallel
+ * random numbers: as easy as 1, 2, 3", 2011).
+ *
+ * Each random word is a pure function of the key (the seed), the stream and
+ * its index in the stream. The bulk fills therefore compute any range of
+ * values independently : large matrices are filled in parallel, by batches of
+ * blocks the compiler vectorizes, and the values don't depend on the number
+ * of threads. Large fills share a set of threads started once, they stay
+ * sequential on the workers of a pool (ex: data-parallel training) and while
+ * another fill uses the threads.
+ *
+ * It also satisfies the UniformRandomBitGenerator requirements, so it can be
+ * used with the standard distributions and algorithms.
+ */
+class Philox {
+ public:
+  using result_type = uint32_t;
+
+  /**
+   * @param seed The key of the generator
+   * @param stream The index of the stream, generators with the same seed and
+   * different streams are independent
+   */
+  explicit Philox(uint64_t seed = 0, uint64_t stream = 0)
+      : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+        stream(stream){};
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /**
+   * @brief Get the next random word of the stream
+   */
+  result_type operator()() {
+    const uint64_t b = position / 4;
+    if (b != cachedBlock) {
+      generate(b, 1, cache);
+      cachedBlock = b;
+    }
+    return cache[position++ % 4];
+  }
+
+  /**
+   * @brief Skips the next `n` words of the stream
+   */
+  void discard(uint64_t n) { position += n; }
+
+  /**
+   * @brief Computes the random words of consecutive blocks (4 words each)
+   *
+   * @param first The index of the first block in the stream
+   * @param nBlocks The number of blocks
+   * @param words The destination of the `4 * nBlocks` words
+   */
+  void generate(uint64_t first, size_t nBlocks, uint32_t *words) const {
+    uint32_t c0[batch], c1[batch], c2[batch], c3[batch];
+
+    for (size_t start = 0; start < nBlocks; start += batch) {
+      const size_t n = std::min(batch, nBlocks - start);
+
+      for (size_t i = 0; i < batch; i++) {
+        const uint64_t counter = first + start + i;
+        c0[i] = static_cast<uint32_t>(counter);
+        c1[i] = static_cast<uint32_t>(counter >> 32);
+        c2[i] = static_cast<uint32_t>(stream);
+        c3[i] = static_cast<uint32_t>(stream >> 32);
+      }
+
+      uint32_t k0 = key[0], k1 = key[1];
+      for (int round = 0; round < 10; round++) {
+        // Independent lanes, vectorized by the compiler
+        for (size_t i = 0; i < batch; i++) {
+          const uint64_t p0 = static_cast<uint64_t>(M0) * c0[i];
+          const uint64_t p1 = static_cast<uint64_t>(M1) * c2[i];
+          const uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c1[i] ^ k0;
+          const uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c3[i] ^ k1;
+          c1[i] = static_cast<uint32_t>(p1);
+          c3[i] = static_cast<uint32_t>(p0);
+          c0[i] = n0;
+          c2[i] = n2;
+        }
+        k0 += W0;
+        k1 += W1;
+      }
+
+      for (size_t i = 0; i < n; i++) {
+        uint32_t *block = words + 4 * (start + i);
+        block[0] = c0[i];
+        block[1] = c1[i];
+        block[2] = c2[i];
+        block[3] = c3[i];
+      }
+    }
+  }
+
+  /**
+   * @brief Fills the values with uniformly distributed numbers and moves the
+   * stream past the words used
+   *
+   * @param values The values to fill
+   * @param n The number of values
+   * @param min The minimum value
+   * @param max The maximum value (excluded)
+   */
+  void fillUniform(Scalar *values, size_t n, double min, double max) {
+    const double scale = (max - min) * 0x1p-32;
+
+    fill(values, n, [=](const uint32_t *words, Scalar *out, size_t count) {
+      for (size_t i = 0; i < count; i++) {
+        out[i] = static_cast<Scalar>(min + words[i] * scale);
+      }
+    });
+  }
+
+  /**
+   * @brief Fills the values with normally distributed numbers (Box-Muller
+   * transform) and moves the stream past the words used
+   *
+   * @param values The values to fill
+   * @param n The number of values
+   * @param mean The mean of the distribution
+   * @param stddev The standard deviation of the distribution
+   */
+  void fillNormal(Scalar *values, size_t n, double mean, double stddev) {
+    fill(values, n, [=](const uint32_t *words, Scalar *out, size_t count) {
+      // Each pair of words gives a pair of values, chunks start on a block
+      for (size_t i = 0; i < count; i += 2) {
+        const double u1 = (words[i] + 0.5) * 0x1p-32;  // In (0, 1)
+        const double u2 = words[i + 1] * 0x1p-32;
+        const double r = stddev * std::sqrt(-2 * std::log(u1));
+        const double theta = 2 * pi * u2;
+
+        out[i] = static_cast<Scalar>(mean + r * std::cos(theta));
+        if (i + 1 < count)
+          out[i + 1] = static_cast<Scalar>(mean + r * std::sin(theta));
+      }
+    });
+  }
+
+  /**
+   * @brief Fills the values with 1 with the given probability, 0 otherwise,
+   * and moves the stream past the words used. Each word gives two values
+   * (16 bits each, the probability is rounded to a multiple of 2^-16).
+   *
+   * @param values The values to fill
+   * @param n The number of values
+   * @param p The probability of a 1
+   */
+  void fillBernoulli(uint8_t *values, size_t n, double p) {
+    const uint32_t threshold = static_cast<uint32_t>(std::lround(p * 65536));
+
+    fill<2>(values, n, [=](const uint32_t *words, uint8_t *out, size_t count) {
+      for (size_t i = 0; i < count / 2; i++) {
+        out[2 * i] = (words[i] & 0xFFFF) < threshold;
+        out[2 * i + 1] = (words[i] >> 16) < threshold;
+      }
+      if (count % 2) out[count - 1] = (words[count / 2] & 0xFFFF) < threshold;
+    });
+  }
+
+ private:
+  static constexpr uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+  static constexpr uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+  static constexpr double pi = 3.14159265358979323846;
+  static constexpr size_t batch = 16;  // Blocks computed together
+  static constexpr size_t chunkWords = 1024;  // Words converted at once
+  static constexpr size_t minParallelWords = 1 << 18;
+
+  uint32_t key[2];
+  uint64_t stream;
+  uint64_t position = 0;  // Index of the next word in the stream
+  uint64_t cachedBlock = std::numeric_limits<uint64_t>::max();
+  uint32_t cache[4] = {};
+
+  /**
+   * Fills the values by chunks of words (in parallel for large fills), value
+   * i always comes from the word i / valuesPerWord after the first block
+   * boundary
+   */
+  template <size_t valuesPerWord = 1, typename T, typename Convert>
+  void fill(T *values, size_t n, Convert convert) {
+    const uint64_t first = (position + 3) / 4;  // Next whole block
+    const size_t nWords = (n + valuesPerWord - 1) / valuesPerWord;
+    const size_t nChunks = (nWords + chunkWords - 1) / chunkWords;
+
+    auto fillChunks = [&](size_t begin, size_t end) {
+      uint32_t words[chunkWords];
+      for (size_t c = begin; c < end; c++) {
+        const size_t offset = c * chunkWords;
+        const size_t count = std::min(chunkWords, nWords - offset);
+        generate(first + offset / 4, (count + 3) / 4, words);
+        convert(words, values + offset * valuesPerWord,
+                std::min(count * valuesPerWord, n - offset * valuesPerWord));
+      }
+    };
+
+    if (nWords < minParallelWords || WorkerPool::inWorker()) {
+      fillChunks(0, nChunks);
+    } else {
+      detail::FillPool &shared = detail::fillPool();
+      std::unique_lock<std::mutex> lock(shared.mtx, std::try_to_lock);
+      const size_t nThreads =
+          lock ? std::min<size_t>(shared.pool.size(),
+                                  nWords / (minParallelWords / 4))
+               : 1;
+
+      // The pool's other workers have nothing to do
+      auto fillShare = [&](int w) {
+        if (static_cast<size_t>(w) >= nThreads) return;
+        fillChunks(nChunks * w / nThreads, nChunks * (w + 1) / nThreads);
+      };
+
+      if (nThreads <= 1) {
+        fillChunks(0, nChunks);
+      } else {
+        shared.pool.run(std::ref(fillShare));  // Wrapped, not allocated
+      }
+    }
+
+    position = (first + (nWords + 3) / 4) * 4;
+  }
+};
+
+namespace detail {
+struct RandomState {
+  std::atomic<uint64_t> seed{
+      std::random_device()() |
+      static_cast<uint64_t>(std::random_device()()) << 32};
+  std::atomic<uint64_t> nextStream{0};
+};
+
+inline RandomState &randomState() {
+  static RandomState state;
+  return state;
+}
+}  // namespace detail
+
+/**
+ * @brief Seeds the generators handed out by `randomGenerator`, the layers
+ * initialized afterwards get the same parameters from one run to another
+ *
+ * @param seed The seed
+ */
+inline void setRandomSeed(uint64_t seed) {
+  detail::randomState().seed = seed;
+  detail::randomState().nextStream = 0;
+}
+
+/**
+ * @brief Get a new generator, independent of the previous ones. Unless
+ * `setRandomSeed` was called, the generators are seeded randomly.
+ */
+inline Philox randomGenerator() {
+  detail::RandomState &state = detail::randomState();
+  return Philox(state.seed, state.nextStream++);
+}
+
+/**
+ * @brief Fills a matrix with uniformly distributed values. A block of a
+ * larger matrix (its columns aren't contiguous) is filled column by column.
+ */
+inline void fillUniform(MatrixRef matrix, Philox &generator, double min,
+                        double max) {
+  if (matrix.outerStride() == matrix.rows()) {
+    generator.fillUniform(matrix.data(), matrix.size(), min, max);
+    return;
+  }
+
+  for (Eigen::Index c = 0; c < matrix.cols(); c++)
+    generator.fillUniform(matrix.col(c).data(), matrix.rows(), min, max);
+}
+
+/**
+ * @brief Fills a matrix with normally distributed values, column by column
+ * for a block of a larger matrix
+ */
+inline void fillNormal(MatrixRef matrix, Philox &generator, double mean,
+                       double stddev) {
+  if (matrix.outerStride() == matrix.rows()) {
+    generator.fillNormal(matrix.data(), matrix.size(), mean, stddev);
+    return;
+  }
+
+  for (Eigen::Index c = 0; c < matrix.cols(); c++)
+    generator.fillNormal(matrix.col(c).data(), matrix.rows(), mean, stddev);
+}
+}  // namespace NeuralNet
@@ -36,6 +36,19 @@ void load(
                  static_cast<std::size_t>(rows * cols * sizeof(_Scalar))));
 }
 
+// Views (ex: a layer's parameters in an arena), same format as a Matrix
+template <class Archive, class _PlainObjectType, int _MapOptions,
+          class _StrideType>
+void save(Archive &ar,
+          Eigen::Map<_PlainObjectType, _MapOptions, _StrideType> const &m) {
+  using _Scalar = typename _PlainObjectType::Scalar;
+  int32_t rows = m.rows();
+  int32_t cols = m.cols();
+  ar(rows);
+  ar(cols);
+  ar(binary_data(m.data(), rows * cols * sizeof(_Scalar)));
+}
+
 template <class Archive, class T1, class T2>
 void save(Archive &ar, const std::tuple<T1, T2> &t) {
   ar(std::get<0>(t), std::get<1>(t));
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <cstdint>
+
+namespace NeuralNet {
+/**
+ * Scalar type of the computations (weights, activations, gradients...).
+ *
+ * Defining `NEURALNET_SINGLE_PRECISION` (CMake option `SINGLE_PRECISION`)
+ * switches the whole network to float32, which doubles the SIMD throughput
+ * and halves the memory traffic and the checkpoints size.
+ *
+ * @note Models saved in one precision can't be loaded in the other.
+ */
+#ifdef NEURALNET_SINGLE_PRECISION
+using Scalar = float;
+#else
+using Scalar = double;
+#endif
+
+using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+using RowMatrix =
+    Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+// Read-only view over any column-major matrix (ex: a `Matrix` or an
+// `Eigen::Map`), binds without copying
+using ConstMatrixRef = Eigen::Ref<const Matrix>;
+
+// Writable view over a column-major matrix or a block of it (ex: a tile of
+// rows)
+using MatrixRef = Eigen::Ref<Matrix>;
+
+// Dropout masks, one byte per value (1 : kept, 0 : dropped)
+using MaskMatrix = Eigen::Matrix<uint8_t, Eigen::Dynamic, Eigen::Dynamic>;
+}  // namespace NeuralNet
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NeuralNet {
+/**
+ * Fixed set of threads running the same task in parallel, one call per
+ * worker.
+ *
+ * The threads are started once and wait between the runs, so dispatching a
+ * task (ex: once per mini-batch) doesn't pay for the threads creation. The
+ * calling thread takes part in every run as the worker 0.
+ *
+ * An exception thrown by a task is caught on its worker, the run still waits
+ * for every worker and then rethrows it on the calling thread.
+ */
+class WorkerPool {
+ public:
+  /**
+   * @param nWorkers The number of workers, including the calling thread
+   */
+  explicit WorkerPool(int nWorkers)
+      : nWorkers(std::max(nWorkers, 1)), errors(this->nWorkers) {
+    for (int w = 1; w < this->nWorkers; w++) {
+      threads.emplace_back(&WorkerPool::work, this, w);
+    }
+  };
+
+  ~WorkerPool() {
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      stop = true;
+    }
+    cvStart.notify_all();
+    for (std::thread &thread : threads) thread.join();
+  };
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  /**
+   * @brief Get the number of workers (including the calling thread)
+   */
+  int size() const { return nWorkers; }
+
+  /**
+   * @brief Whether the calling thread is running the task of a pool, in which
+   * case nested parallel work would oversubscribe the cores
+   */
+  static bool inWorker() { return insideTask; }
+
+  /**
+   * @brief Runs the task on every worker and waits for all of them
+   *
+   * @param task The task, called with the worker's index in [0, size())
+   *
+   * @throw The first exception (by worker index) thrown by the task, once
+   * every worker is done
+   */
+  void run(const std::function<void(int)> &task) {
+    if (threads.empty()) return task(0);
+
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      this->task = &task;
+      pending = nWorkers - 1;
+      generation++;
+    }
+    cvStart.notify_all();
+
+    execute(task, 0);
+
+    {
+      std::unique_lock<std::mutex> lock(mtx);
+      cvDone.wait(lock, [this] { return pending == 0; });
+      this->task = nullptr;
+    }
+
+    for (std::exception_ptr &error : errors) {
+      if (!error) continue;
+      std::exception_ptr first = error;
+      std::fill(errors.begin(), errors.end(), nullptr);
+      std::rethrow_exception(first);
+    }
+  };
+
+ private:
+  int nWorkers;
+  std::vector<std::thread> threads;
+  std::mutex mtx;
+  std::condition_variable cvStart, cvDone;
+  const std::function<void(int)> *task = nullptr;
+  std::vector<std::exception_ptr> errors;  // Of the last run, per worker
+  static inline thread_local bool insideTask = false;
+  int pending = 0;
+  unsigned long generation = 0;  // Incremented by each run
+  bool stop = false;
+
+  /**
+   * Workers loop: wait for the next run, execute the task and notify the
+   * caller once every worker is done.
+   */
+  void work(int w) {
+    unsigned long lastGeneration = 0;
+    std::unique_lock<std::mutex> lock(mtx);
+
+    while (true) {
+      cvStart.wait(lock,
+                   [&] { return stop || generation != lastGeneration; });
+
+      if (stop) return;
+
+      lastGeneration = generation;
+      const std::function<void(int)> &current = *task;
+
+      lock.unlock();
+      execute(current, w);
+      lock.lock();
+
+      if (--pending == 0) cvDone.notify_one();
+    }
+  };
+
+  /**
+   * Calls the task, keeping the exception it throws for the calling thread
+   */
+  void execute(const std::function<void(int)> &task, int w) {
+    const bool nested = insideTask;
+    insideTask = true;
+    try {
+      task(w);
+    } catch (...) {
+      errors[w] = std::current_exception();
+    }
+    insideTask = nested;
+  };
+};
+}  // namespace NeuralNet
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Eigen/Dense>
+#include <cassert>
+#include <vector>
+
+#include "ParameterArena.hpp"
+#include "Types.hpp"
+
+namespace NeuralNet {
+/**
+ * Buffers of a training step (the backpropagation intermediates), one set per
+ * layer.
+ *
+ * The buffers are sized once from the layers' shapes and the batch size, then
+ * reused across batches. They are only reallocated when the batch size
+ * changes, so a steady-state training step doesn't allocate any memory.
+ *
+ * The workers of a data-parallel training each own a workspace, which then
+ * also holds their shard of the batch, the layers' outputs for it and their
+ * gradients.
+ */
+struct Workspace {
+  std::vector<Matrix> beta;   // dL/da of each layer's outputs
+  std::vector<Matrix> delta;  // dL/dz of each layer
+
+  // Data-parallel workers only
+  AlignedBuffer grads;  // Gradients, laid out like the parameters arena
+  std::vector<Matrix> outputs;  // Inputs and outputs of each layer
+  std::vector<MaskMatrix> masks;  // Dropout masks of the shard
+  Matrix logits;  // Output layer's weighted sums (fused softmax head)
+  Matrix y;  // Labels of the shard
+  double loss = 0, accuracy = 0;  // Metrics of the shard
+
+  /**
+   * @brief Sizes the buffers
+   *
+   * @param layerSizes The number of neurons of each layer
+   * @param batchSize The number of samples per batch
+   * @param withOutputs Whether to also size the layers' outputs and the
+   * gradients (data-parallel workers)
+   * @param nParameters The size of the parameters arena
+   */
+  void init(const std::vector<int> &layerSizes, int batchSize,
+            bool withOutputs = false, size_t nParameters = 0) {
+    const size_t nLayers = layerSizes.size();
+
+    beta.resize(nLayers);
+    delta.resize(nLayers);
+
+    for (size_t l = 0; l < nLayers; l++) {
+      beta[l].resize(batchSize, layerSizes[l]);
+      delta[l].resize(batchSize, layerSizes[l]);
+    }
+
+    if (!withOutputs) return;
+
+    grads.assign(nParameters, 0);  // The padding of the blocks stays at 0
+    outputs.resize(nLayers);
+    masks.resize(nLayers);
+    for (size_t l = 0; l < nLayers; l++) {
+      outputs[l].resize(batchSize, layerSizes[l]);
+    }
+  }
+
+  /**
+   * @brief The number of layers the workspace is sized for
+   */
+  size_t size() const { return beta.size(); }
+};
+}  // namespace NeuralNet
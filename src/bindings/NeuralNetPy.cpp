@@ -10,20 +10,28 @@
 #include <pybind11/stl.h>
 #include <pybind11/stl_bind.h>
 
+#include "InferenceSession.hpp"
 #include "Model.hpp"
 #include "Network.cpp"
 #include "Network.hpp"
+#include "NumpyArrays.hpp"  // NumPy arrays views
+#include "PyCallback.hpp"  // Callbacks defined in Python
 #include "TemplateBindings.hpp"  // Template classes binding functions
+#include "TrainingFuture.hpp"  // Asynchronous training handle
 #include "callbacks/CSVLogger.hpp"
 #include "callbacks/Callback.hpp"
 #include "callbacks/EarlyStopping.hpp"
 #include "callbacks/ModelCheckpoint.hpp"
+#include "data/DatasetFile.hpp"
+#include "data/MappedTrainingData.hpp"
 #include "layers/Dense.hpp"
 #include "layers/Flatten.hpp"
 #include "layers/Layer.hpp"
 #include "optimizers/Optimizer.hpp"
 #include "optimizers/optimizers.hpp"
+#include "schedulers/schedulers.hpp"
 #include "utils/Enums.hpp"
+#include "utils/Random.hpp"
 
 namespace py = pybind11;
 
@@ -70,6 +78,38 @@ PYBIND11_MODULE(NeuralNetPy, m) {
       .value("MCE", LOSS::MCE)
       .value("BCE", LOSS::BCE);
 
+  py::enum_<TRAINING_MODE>(m, "TRAINING_MODE")
+      .value("SEQUENTIAL", TRAINING_MODE::SEQUENTIAL,
+             "Train on each mini-batch on a single thread")
+      .value("DATA_PARALLEL", TRAINING_MODE::DATA_PARALLEL,
+             "Split each mini-batch across worker threads")
+      .value("HOGWILD", TRAINING_MODE::HOGWILD,
+             "Lock-free asynchronous SGD, one mini-batch per worker thread");
+
+  py::enum_<UPDATE_SCHEDULE>(m, "UPDATE_SCHEDULE")
+      .value("PER_LAYER", UPDATE_SCHEDULE::PER_LAYER,
+             "Update each layer as soon as its gradients are computed")
+      .value("AFTER_BACKPROP", UPDATE_SCHEDULE::AFTER_BACKPROP,
+             "Update all the layers in a single step, split across threads");
+
+  py::enum_<DTYPE>(m, "DTYPE")
+      .value("FLOAT32", DTYPE::FLOAT32, "32 bits floating point samples")
+      .value("UINT8", DTYPE::UINT8, "Unsigned bytes samples (ex: pixels)")
+      .value("FLOAT64", DTYPE::FLOAT64, "64 bits floating point samples");
+
+  m.def("setRandomSeed", &setRandomSeed, py::arg("seed"), R"pbdoc(
+    Seeds the random generator used to initialize the weights and to draw the dropout masks (of the ``Dropout`` layers without a seed). The layers added afterwards get the same weights from one run to another.
+
+    .. highlight: python
+    .. code-block:: python
+        :caption: Example
+
+        import NeuralNetPy as NNP
+
+        NNP.setRandomSeed(42)
+        network = NNP.models.Network()
+  )pbdoc");
+
   py::module optimizers_m = m.def_submodule("optimizers", R"pbdoc(
       Optimizers
       ----------
@@ -82,15 +122,22 @@ PYBIND11_MODULE(NeuralNetPy, m) {
           :recursive:
     )pbdoc");
 
-  py::class_<Optimizer, std::shared_ptr<Optimizer>>(optimizers_m, "Optimizer");
+  py::class_<Optimizer, std::shared_ptr<Optimizer>>(optimizers_m, "Optimizer")
+      .def_property("alpha", &Optimizer::getAlpha, &Optimizer::setAlpha,
+                    "The learning rate");
 
   py::class_<SGD, Optimizer, std::shared_ptr<SGD>>(optimizers_m, "SGD", R"pbdoc(
         For more information on `Stochastic Gradient Descent <https://en.wikipedia.org/wiki/Stochastic_gradient_descent>`
 
         :param alpha: The learning rate, defaults to 0.001
         :type alpha: float
+        :param momentum: The momentum factor, the fraction of the previous update carried over, defaults to 0 (plain gradient descent)
+        :type momentum: float
+        :param nesterov: Whether to use the Nesterov momentum, defaults to False
+        :type nesterov: bool
       )pbdoc")
-      .def(py::init<double>(), py::arg("alpha") = 0.001);
+      .def(py::init<double, double, bool>(), py::arg("alpha") = 0.001,
+           py::arg("momentum") = 0, py::arg("nesterov") = false);
 
   py::class_<Adam, Optimizer, std::shared_ptr<Adam>>(optimizers_m, "Adam",
                                                      R"pbdoc(
@@ -109,6 +156,130 @@ PYBIND11_MODULE(NeuralNetPy, m) {
            py::arg("beta1") = 0.9, py::arg("beta2") = 0.999,
            py::arg("epsilon") = 10E-8);
 
+  py::class_<AdamW, Adam, std::shared_ptr<AdamW>>(optimizers_m, "AdamW",
+                                                  R"pbdoc(
+        Adam with decoupled weight decay, for more information on `AdamW <https://arxiv.org/abs/1711.05101>`
+
+        :param alpha: The learning rate, defaults to 0.001
+        :type alpha: float
+        :param beta1: The exponential decay rate for the first moment estimates, defaults to 0.9
+        :type beta1: float
+        :param beta2: The exponential decay rate for the second-moment estimates, defaults to 0.999
+        :type beta2: float
+        :param epsilon: A small constant for numerical stability, defaults to 10E-8
+        :type epsilon: float
+        :param weightDecay: The decay rate of the parameters (scaled by the learning rate), defaults to 0.01
+        :type weightDecay: float
+      )pbdoc")
+      .def(py::init<double, double, double, double, double>(),
+           py::arg("alpha") = 0.001, py::arg("beta1") = 0.9,
+           py::arg("beta2") = 0.999, py::arg("epsilon") = 10E-8,
+           py::arg("weightDecay") = 0.01);
+
+  py::class_<LRScheduler, std::shared_ptr<LRScheduler>>(optimizers_m,
+                                                        "LRScheduler", R"pbdoc(
+        Learning rate schedule, the mini-batch training sets the optimizer's learning rate from it at every batch or at every epoch (see ``Network.setScheduler``). The schedule starts over at every training, from the optimizer's learning rate, which the optimizer gets back once the training is over.
+      )pbdoc")
+      .def("getRate", &LRScheduler::getRate, py::arg("step"),
+           py::arg("baseRate"), R"pbdoc(
+        Get the learning rate of a step (batch or epoch) of the training
+
+        :param step: The number of batches (or epochs) since the training began
+        :type step: int
+        :param baseRate: The learning rate of the optimizer
+        :type baseRate: float
+      )pbdoc");
+
+  py::class_<StepLR, LRScheduler, std::shared_ptr<StepLR>>(optimizers_m,
+                                                           "StepLR", R"pbdoc(
+        Decays the learning rate by ``gamma`` every ``stepSize`` steps
+
+        :param stepSize: The number of steps between two decays
+        :type stepSize: int
+        :param gamma: The decay factor, defaults to 0.1
+        :type gamma: float
+        :param perBatch: Whether the steps are batches (otherwise epochs), defaults to False
+        :type perBatch: bool
+      )pbdoc")
+      .def(py::init<int, double, bool>(), py::arg("stepSize"),
+           py::arg("gamma") = 0.1, py::arg("perBatch") = false);
+
+  py::class_<CosineAnnealingLR, LRScheduler,
+             std::shared_ptr<CosineAnnealingLR>>(optimizers_m,
+                                                 "CosineAnnealingLR", R"pbdoc(
+        Anneals the learning rate from the optimizer's rate to ``minRate`` along a half cosine over ``nSteps`` steps
+
+        :param nSteps: The number of steps of the annealing
+        :type nSteps: int
+        :param minRate: The learning rate at the end of the annealing, defaults to 0
+        :type minRate: float
+        :param perBatch: Whether the steps are batches (otherwise epochs), defaults to True
+        :type perBatch: bool
+      )pbdoc")
+      .def(py::init<int, double, bool>(), py::arg("nSteps"),
+           py::arg("minRate") = 0, py::arg("perBatch") = true);
+
+  py::class_<OneCycleLR, LRScheduler, std::shared_ptr<OneCycleLR>>(
+      optimizers_m, "OneCycleLR", R"pbdoc(
+        One-cycle policy, the learning rate rises from ``maxRate / divFactor`` to ``maxRate`` then anneals to ``maxRate / (divFactor * finalDivFactor)``. The rate changes at every batch.
+
+        :param maxRate: The peak learning rate
+        :type maxRate: float
+        :param nSteps: The number of batches of the cycle
+        :type nSteps: int
+        :param pctStart: The fraction of the cycle spent rising, defaults to 0.3
+        :type pctStart: float
+        :param divFactor: The ratio between the peak and the initial rate, defaults to 25
+        :type divFactor: float
+        :param finalDivFactor: The ratio between the initial and the final rate, defaults to 1e4
+        :type finalDivFactor: float
+      )pbdoc")
+      .def(py::init<double, int, double, double, double>(), py::arg("maxRate"),
+           py::arg("nSteps"), py::arg("pctStart") = 0.3,
+           py::arg("divFactor") = 25, py::arg("finalDivFactor") = 1e4);
+
+  py::class_<WarmupLR, LRScheduler, std::shared_ptr<WarmupLR>>(
+      optimizers_m, "WarmupLR", R"pbdoc(
+        Raises the learning rate linearly up to the optimizer's rate during the first ``warmupSteps`` steps, then hands over to another schedule
+
+        :param warmupSteps: The number of steps of the warmup
+        :type warmupSteps: int
+        :param after: The schedule that follows the warmup, its steps are counted from the end of the warmup, defaults to None (the optimizer's rate)
+        :type after: LRScheduler
+        :param perBatch: Whether the steps are batches (otherwise epochs), defaults to True
+        :type perBatch: bool
+
+        .. highlight: python
+        .. code-block:: python
+            :caption: Warmup then cosine decay
+
+            import NeuralNetPy as NNP
+
+            scheduler = NNP.optimizers.WarmupLR(100, NNP.optimizers.CosineAnnealingLR(900))
+            network.setScheduler(scheduler)
+      )pbdoc")
+      .def(py::init<int, std::shared_ptr<LRScheduler>, bool>(),
+           py::arg("warmupSteps"), py::arg("after") = nullptr,
+           py::arg("perBatch") = true);
+
+  py::class_<ReduceLROnPlateau, LRScheduler,
+             std::shared_ptr<ReduceLROnPlateau>>(optimizers_m,
+                                                 "ReduceLROnPlateau", R"pbdoc(
+        Reduces the learning rate once the loss (the test loss when there's test data) stops improving, the rate changes at the end of the epochs
+
+        :param factor: The factor applied to the learning rate at each reduction, defaults to 0.1
+        :type factor: float
+        :param patience: The number of epochs without improvement after which the learning rate is reduced, defaults to 10
+        :type patience: int
+        :param minDelta: The minimum decrease of the loss that counts as an improvement, defaults to 1e-4
+        :type minDelta: float
+        :param minRate: The lower bound of the learning rate, defaults to 0
+        :type minRate: float
+      )pbdoc")
+      .def(py::init<double, int, double, double>(), py::arg("factor") = 0.1,
+           py::arg("patience") = 10, py::arg("minDelta") = 1e-4,
+           py::arg("minRate") = 0);
+
   py::module layers_m = m.def_submodule("layers", R"pbdoc(
       Layers
       ------
@@ -156,7 +327,7 @@ PYBIND11_MODULE(NeuralNetPy, m) {
 
     :param rate: A float between 0 and 1. It represents the fraction of the inputs to drop.
     :type rate: float32
-    :param seed: An integer used as random seed. If not provided a random seed will be generated.
+    :param seed: An integer used as random seed. If not provided, the masks are drawn from the generator seeded by ``setRandomSeed``.
     :type seed: int
   )pbdoc")
       .def(py::init<float, int>(), py::arg("rate"), py::arg("seed") = 0)
@@ -202,10 +373,26 @@ PYBIND11_MODULE(NeuralNetPy, m) {
           :recursive:
     )pbdoc");
 
-  py::class_<Callback, std::shared_ptr<Callback>>(callbacks_m, "Callback",
-                                                  R"pbdoc(
-      This is the base class for all callbacks.
-    )pbdoc");
+  py::class_<Callback, PyCallback, std::shared_ptr<Callback>>(
+      callbacks_m, "Callback", R"pbdoc(
+      This is the base class for all callbacks. It can be subclassed in Python by defining any of the ``onTrainBegin``, ``onTrainEnd``, ``onEpochBegin``, ``onEpochEnd``, ``onBatchBegin`` and ``onBatchEnd`` hooks, they're called with the training logs (``EPOCH``, ``LOSS``, ``ACCURACY``, ``TEST_LOSS`` and ``TEST_ACCURACY``).
+
+      The training runs without the GIL, it's only acquired while a hook runs. Raising an exception in a hook interrupts the training.
+
+      .. highlight: python
+      .. code-block:: python
+          :caption: Example
+
+          class LossPrinter(NNP.callbacks.Callback):
+              def __init__(self):
+                  super().__init__()
+
+              def onEpochEnd(self, logs):
+                  print(logs["EPOCH"], logs["LOSS"])
+
+          network.train(trainingData, 10, [LossPrinter()])
+    )pbdoc")
+      .def(py::init<>());
 
   py::class_<EarlyStopping, Callback, std::shared_ptr<EarlyStopping>>(
       callbacks_m, "EarlyStopping", R"pbdoc(
@@ -334,6 +521,95 @@ PYBIND11_MODULE(NeuralNetPy, m) {
         The inputs and labels must be of the same length.
   )pbdoc");
 
+  m.def("writeDataset",
+        &DatasetFile::write<std::vector<std::vector<double>>,
+                            std::vector<double>>,
+        py::arg("path"), py::arg("inputs"), py::arg("labels"),
+        py::arg("dtype") = DTYPE::FLOAT32,
+        "Writes 2 dimensional inputs and their labels to a dataset file that "
+        "can be loaded with ``MappedTrainingData``");
+
+  m.def("writeDataset",
+        &DatasetFile::write<std::vector<std::vector<std::vector<double>>>,
+                            std::vector<double>>,
+        py::arg("path"), py::arg("inputs"), py::arg("labels"),
+        py::arg("dtype") = DTYPE::FLOAT32,
+        "Writes 3 dimensional inputs and their labels to a dataset file that "
+        "can be loaded with ``MappedTrainingData``");
+
+  py::class_<MappedTrainingData>(m, "MappedTrainingData", R"pbdoc(
+    Represents training data read straight out of dataset files. The files are memory-mapped and the mini-batches are gathered from them on demand, which allows training on datasets that don't fit in memory.
+
+    A dataset file starts with a 64 bytes header followed by the samples (row-major, float32 or uint8) and the labels (float32). It can be written with ``writeDataset``.
+
+    .. highlight: python
+    .. code-block:: python
+        :caption: Example
+
+        import NeuralNetPy as NNP
+
+        NNP.writeDataset("train.nnds", inputs, labels, NNP.DTYPE.UINT8)
+
+        # Scaling the pixels to [0, 1]
+        trainingData = NNP.MappedTrainingData("train.nnds", scale=1. / 255)
+        trainingData.batch(128, shuffle=True, reshuffle=True)
+
+    .. warning::
+        The data must be batched before training.
+  )pbdoc")
+      .def(py::init<const std::string &, const std::string &, double>(),
+           py::arg("trainPath"), py::arg("testPath") = "",
+           py::arg("scale") = 1.0)
+      .def("batch", &MappedTrainingData::batch, py::arg("batchSize"),
+           py::arg("stratified") = false, py::arg("shuffle") = false,
+           py::arg("dropLast") = false, py::arg("verbose") = false,
+           py::arg("reshuffle") = false, py::arg("seed") = 0,
+           "This method will separate the samples into batches of the "
+           "specified size")
+      .def("prefetch", &MappedTrainingData::prefetch, py::arg("depth") = 2,
+           py::arg("nWorkers") = 1,
+           "This method will make the training prepare the next ``depth`` "
+           "mini-batches on ``nWorkers`` background threads");
+
+  py::class_<ArrayTrainingData>(m, "ArrayTrainingData", R"pbdoc(
+    Represents training data viewing NumPy arrays without copying them. The samples are read straight from the arrays when the mini-batches are gathered, instead of being converted one Python float at a time.
+
+    The samples can be C-contiguous ``float32``, ``float64`` or ``uint8`` arrays of any dimension (one sample per element of the first axis), other arrays are converted once. The labels are class indexes (1 dimensional array) or vectors (2 dimensional array).
+
+    .. highlight: python
+    .. code-block:: python
+        :caption: Example
+
+        import numpy as np
+        import NeuralNetPy as NNP
+
+        # x_train : uint8 array of shape (60000, 28, 28)
+        trainingData = NNP.ArrayTrainingData(x_train, y_train, scale=1. / 255)
+        trainingData.batch(128, shuffle=True, reshuffle=True)
+
+    .. warning::
+        The arrays mustn't be modified during the training.
+  )pbdoc")
+      .def(py::init([](const py::array &inputs, const py::array &labels,
+                       const py::array &testInputs,
+                       const py::array &testLabels, double scale) {
+             return static_cast<ArrayTrainingData *>(new PyArrayTrainingData(
+                 inputs, labels, testInputs, testLabels, scale));
+           }),
+           py::arg("inputs"), py::arg("labels"),
+           py::arg("testInputs") = py::array(),
+           py::arg("testLabels") = py::array(), py::arg("scale") = 1.0)
+      .def("batch", &ArrayTrainingData::batch, py::arg("batchSize"),
+           py::arg("stratified") = false, py::arg("shuffle") = false,
+           py::arg("dropLast") = false, py::arg("verbose") = false,
+           py::arg("reshuffle") = false, py::arg("seed") = 0,
+           "This method will separate the samples into batches of the "
+           "specified size")
+      .def("prefetch", &ArrayTrainingData::prefetch, py::arg("depth") = 2,
+           py::arg("nWorkers") = 1,
+           "This method will make the training prepare the next ``depth`` "
+           "mini-batches on ``nWorkers`` background threads");
+
   /**
    * > You can only bind explicitly instantiated versions of your function
    *
@@ -393,7 +669,7 @@ PYBIND11_MODULE(NeuralNetPy, m) {
             NNP.models.Model.load_from_file("network.bin", network)
       )pbdoc");
 
-  py::class_<Network, Model>(models_m, "Network", R"pbdoc(
+  py::class_<Network, Model> networkClass(models_m, "Network", R"pbdoc(
       This is the base of a Neural Network. You can setup the network with the given optimizer and loss function.
 
       :param optimizer: The optimizer to be used from the ``optimizers`` module
@@ -409,11 +685,69 @@ PYBIND11_MODULE(NeuralNetPy, m) {
 
           network = NNP.models.Network()
           network.setup(optimizer=NNP.SGD(0.01), loss=NNP.LOSS.MCQ)
-      )pbdoc")
-      .def(py::init<>())
+      )pbdoc");
+
+  networkClass.def(py::init<>())
       .def("getSlug", &Network::getSlug)
       .def("setup", &Network::setup, py::arg("optimizer"),
            py::arg("loss") = LOSS::QUADRATIC)
+      .def("setTrainingMode", &Network::setTrainingMode, py::arg("mode"),
+           py::arg("nThreads") = 0, R"pbdoc(
+            Set how the mini-batches are trained on. With ``DATA_PARALLEL``, every mini-batch is split across worker threads and their gradients are reduced before a single optimizer step. The results are deterministic for a given number of threads.
+
+            With ``HOGWILD``, each worker thread trains on whole mini-batches and applies its updates to the shared parameters without locks. It scales better but isn't deterministic, and only works with the ``SGD`` optimizer and per-epoch learning rate schedules (a ``ValueError`` is raised otherwise). The batch callbacks are called by the workers, one at a time.
+
+            :param mode: The training mode from the ``TRAINING_MODE`` enum
+            :type mode: TRAINING_MODE
+            :param nThreads: The number of worker threads, defaults to ``0`` (every core)
+            :type nThreads: int
+
+            .. highlight: python
+            .. code-block:: python
+                :caption: Example
+
+                import NeuralNetPy as NNP
+
+                network = NNP.models.Network()
+                network.setTrainingMode(NNP.TRAINING_MODE.DATA_PARALLEL, 4)
+
+            .. note::
+                Only the mini-batch training (batched ``TrainingData``) is parallelized.
+           )pbdoc")
+      .def("setScheduler", &Network::setScheduler, py::arg("scheduler"),
+           R"pbdoc(
+            Set the learning rate schedule of the mini-batch training. The optimizer's learning rate is set from the schedule at the beginning of every batch or epoch, the schedule starts over at every training and the optimizer gets its learning rate back at the end of it.
+
+            :param scheduler: The learning rate schedule (None to remove it)
+            :type scheduler: LRScheduler
+
+            .. highlight: python
+            .. code-block:: python
+                :caption: Example
+
+                import NeuralNetPy as NNP
+
+                network = NNP.models.Network()
+                network.setup(optimizer=NNP.optimizers.SGD(0.1, 0.9), loss=NNP.LOSS.MCE)
+                network.setScheduler(NNP.optimizers.StepLR(10, 0.5))
+           )pbdoc")
+      .def("setUpdateSchedule", &Network::setUpdateSchedule,
+           py::arg("schedule"), R"pbdoc(
+            Set when the optimizer updates the parameters. With ``AFTER_BACKPROP``, the gradients of all the layers are computed first, then every layer is updated in a single step split across the worker threads (the ``nThreads`` of ``setTrainingMode``). The resulting parameters are the same as with ``PER_LAYER``.
+
+            :param schedule: The update schedule from the ``UPDATE_SCHEDULE`` enum
+            :type schedule: UPDATE_SCHEDULE
+
+            .. highlight: python
+            .. code-block:: python
+                :caption: Example
+
+                import NeuralNetPy as NNP
+
+                network = NNP.models.Network()
+                network.setTrainingMode(NNP.TRAINING_MODE.SEQUENTIAL, 4)
+                network.setUpdateSchedule(NNP.UPDATE_SCHEDULE.AFTER_BACKPROP)
+           )pbdoc")
       .def("addLayer", &Network::addLayer, R"pbdoc(
             Add a layer to the network. 
 
@@ -458,6 +792,37 @@ PYBIND11_MODULE(NeuralNetPy, m) {
           )pbdoc")
       .def("getNumLayers", &Network::getNumLayers,
            "Return the number of layers in the network.")
+      .def(
+          "train",
+          [](Network &network, const py::array &inputs,
+             const py::array &targets, int epochs,
+             const std::vector<std::shared_ptr<Callback>> &callbacks,
+             bool progBar) {
+            const py::array x = contiguousArray(inputs);
+            const py::array y = contiguousArray(targets);
+            const ArrayView xView = viewArray(x), yView = viewArray(y);
+            py::gil_scoped_release release;
+            return network.train(xView, yView, epochs, callbacks, progBar);
+          },
+          py::arg("inputs"), py::arg("targets"), py::arg("epochs"),
+          py::arg("callbacks") = std::vector<std::shared_ptr<Callback>>(),
+          py::arg("progBar") = true,
+          R"pbdoc(
+            Train the network on NumPy arrays, without converting them to lists. The training is the same as with lists of inputs and labels (use ``ArrayTrainingData`` to train on mini-batches).
+
+            :param inputs: The samples, one per element of the first axis (``float32``, ``float64`` or ``uint8``)
+            :type inputs: numpy.ndarray
+            :param targets: The class indexes or target vectors
+            :type targets: numpy.ndarray
+            :param epochs: The number of epochs to train the network
+            :type epochs: int
+            :param callbacks: A list of callbacks to be used during the training
+            :type callbacks: list[Callback]
+            :param progBar: Whether or not to enable the progress bar
+            :type progBar: bool
+            :return: The average loss throughout the training
+            :rtype: float
+      )pbdoc")
       .def("train",
            static_cast<double (Network::*)(
                std::vector<std::vector<double>>, std::vector<double>, int,
@@ -466,6 +831,7 @@ PYBIND11_MODULE(NeuralNetPy, m) {
            py::arg("inputs"), py::arg("targets"), py::arg("epochs"),
            py::arg("callbacks") = std::vector<std::shared_ptr<Callback>>(),
            py::arg("progBar") = true,
+           py::call_guard<py::gil_scoped_release>(),
            R"pbdoc(
             Train the network by passing it 2 dimensional inputs (vectors).
 
@@ -513,6 +879,7 @@ PYBIND11_MODULE(NeuralNetPy, m) {
            py::arg("inputs"), py::arg("targets"), py::arg("epochs"),
            py::arg("callbacks") = std::vector<std::shared_ptr<Callback>>(),
            py::arg("progBar") = true,
+           py::call_guard<py::gil_scoped_release>(),
            R"pbdoc(
         Train the network by passing it a list of 3 dimensional inputs (matrices).
 
@@ -560,12 +927,13 @@ PYBIND11_MODULE(NeuralNetPy, m) {
       .def("train",
            static_cast<double (Network::*)(
                TrainingData<std::vector<std::vector<double>>,
-                            std::vector<double>>,
+                            std::vector<double>> &,
                int, const std::vector<std::shared_ptr<Callback>>, bool)>(
                &Network::train),
            py::arg("trainingData"), py::arg("epochs"),
            py::arg("callbacks") = std::vector<std::shared_ptr<Callback>>(),
            py::arg("progBar") = true,
+           py::call_guard<py::gil_scoped_release>(),
            R"pbdoc(
         Train the network by passing it a ``TrainingData2dI`` object.
 
@@ -610,12 +978,13 @@ PYBIND11_MODULE(NeuralNetPy, m) {
       .def("train",
            static_cast<double (Network::*)(
                TrainingData<std::vector<std::vector<std::vector<double>>>,
-                            std::vector<double>>,
+                            std::vector<double>> &,
                int, const std::vector<std::shared_ptr<Callback>>, bool)>(
                &Network::train),
            py::arg("trainingData"), py::arg("epochs"),
            py::arg("callbacks") = std::vector<std::shared_ptr<Callback>>(),
            py::arg("progBar") = true,
+           py::call_guard<py::gil_scoped_release>(),
            R"pbdoc(
         Train the network by passing it a ``TrainingData3dI`` object.
 
@@ -669,9 +1038,72 @@ PYBIND11_MODULE(NeuralNetPy, m) {
 
             loss = network.train(trainingData, 10)
       )pbdoc")
+      .def("train",
+           static_cast<double (Network::*)(
+               MappedTrainingData &, int,
+               const std::vector<std::shared_ptr<Callback>>, bool)>(
+               &Network::train),
+           py::arg("trainingData"), py::arg("epochs"),
+           py::arg("callbacks") = std::vector<std::shared_ptr<Callback>>(),
+           py::arg("progBar") = true,
+           py::call_guard<py::gil_scoped_release>(),
+           R"pbdoc(
+        Train the network by passing it a batched ``MappedTrainingData`` object.
+
+        :param trainingData: A ``MappedTrainingData`` object
+        :type trainingData: MappedTrainingData
+        :param epochs: The number of epochs to train the network
+        :type epochs: int
+        :param callbacks: A list of callbacks to be used during the training
+        :type callbacks: list[Callback]
+        :param progBar: Whether or not to enable the progress bar
+        :type progBar: bool
+        :return: The average loss throughout the training
+        :rtype: float
+      )pbdoc")
+      .def("train",
+           static_cast<double (Network::*)(
+               ArrayTrainingData &, int,
+               const std::vector<std::shared_ptr<Callback>>, bool)>(
+               &Network::train),
+           py::arg("trainingData"), py::arg("epochs"),
+           py::arg("callbacks") = std::vector<std::shared_ptr<Callback>>(),
+           py::arg("progBar") = true,
+           py::call_guard<py::gil_scoped_release>(),
+           R"pbdoc(
+        Train the network by passing it an ``ArrayTrainingData`` object, it's trained on as a single batch when it isn't batched.
+
+        :param trainingData: An ``ArrayTrainingData`` object
+        :type trainingData: ArrayTrainingData
+        :param epochs: The number of epochs to train the network
+        :type epochs: int
+        :param callbacks: A list of callbacks to be used during the training
+        :type callbacks: list[Callback]
+        :param progBar: Whether or not to enable the progress bar
+        :type progBar: bool
+        :return: The average loss throughout the training
+        :rtype: float
+      )pbdoc")
+      .def(
+          "predict",
+          [](const Network &network, const py::array &inputs) {
+            const py::array array = contiguousArray(inputs);
+            const ArrayView view = viewArray(array);
+            py::gil_scoped_release release;
+            return network.predict(view);
+          },
+          py::arg("inputs"), R"pbdoc(
+        Feed forward the given NumPy array through the network and return the predictions/outputs. The array is read without being converted to lists.
+
+        :param inputs: The inputs, one sample per element of the first axis (``float32``, ``float64`` or ``uint8``)
+        :type inputs: numpy.ndarray
+        :return: A matrix representing the outputs of the network for the given inputs
+        :rtype: numpy.ndarray
+      )pbdoc")
       .def("predict",
-           static_cast<Eigen::MatrixXd (Network::*)(
-               std::vector<std::vector<double>>)>(&Network::predict),
+           static_cast<Matrix (Network::*)(std::vector<std::vector<double>>)
+                           const>(&Network::predict),
+           py::call_guard<py::gil_scoped_release>(),
            R"pbdoc(
         Feed forward the given inputs through the network and return the predictions/outputs.
 
@@ -681,9 +1113,10 @@ PYBIND11_MODULE(NeuralNetPy, m) {
         :rtype: numpy.ndarray
       )pbdoc")
       .def("predict",
-           static_cast<Eigen::MatrixXd (Network::*)(
-               std::vector<std::vector<std::vector<double>>>)>(
+           static_cast<Matrix (Network::*)(
+               std::vector<std::vector<std::vector<double>>>) const>(
                &Network::predict),
+           py::call_guard<py::gil_scoped_release>(),
            R"pbdoc(
         Feed forward the given inputs through the network and return the predictions/outputs.
 
@@ -692,4 +1125,115 @@ PYBIND11_MODULE(NeuralNetPy, m) {
         :return: A matrix representing the outputs of the network for the given inputs
         :rtype: numpy.ndarray
       )pbdoc");
+
+  bindTrainAsync<
+      TrainingData<std::vector<std::vector<double>>, std::vector<double>>>(
+      networkClass, R"pbdoc(
+        Train the network on a background thread and return a ``TrainingFuture`` right away. The GIL is released during the training, so the other Python threads keep running.
+
+        :param trainingData: The training data (``TrainingData2dI``, ``TrainingData3dI``, ``MappedTrainingData`` or ``ArrayTrainingData``)
+        :param epochs: The number of epochs to train the network
+        :type epochs: int
+        :param callbacks: A list of callbacks to be used during the training, they're called from the training thread
+        :type callbacks: list[Callback]
+        :param progBar: Whether or not to enable the progress bar
+        :type progBar: bool
+        :return: A handle on the training
+        :rtype: TrainingFuture
+
+        .. highlight: python
+        .. code-block:: python
+            :caption: Example
+
+            future = network.trainAsync(trainingData, 10)
+
+            while not future.done():
+                # ... other work
+                future.wait(timeout=1.0)
+
+            loss = future.result()
+
+        .. warning::
+            The network and the training data mustn't be used until the training is over.
+      )pbdoc");
+  bindTrainAsync<TrainingData<std::vector<std::vector<std::vector<double>>>,
+                              std::vector<double>>>(networkClass, "");
+  bindTrainAsync<MappedTrainingData>(networkClass, "");
+  bindTrainAsync<ArrayTrainingData>(networkClass, "");
+
+  py::class_<TrainingFuture>(models_m, "TrainingFuture", R"pbdoc(
+      Handle of a training running on a background thread, returned by ``Network.trainAsync``. Waiting on it releases the GIL. The handle waits for the training to be over when it's destroyed.
+      )pbdoc")
+      .def("done", &TrainingFuture::done, "Whether the training is over")
+      .def("wait", &TrainingFuture::wait, py::arg("timeout") = py::none(),
+           "Wait for the training to be over, at most ``timeout`` seconds "
+           "when given. Return whether the training is over.")
+      .def("result", &TrainingFuture::result,
+           "Wait for the training to be over and return its loss");
+
+  py::class_<InferenceSession>(models_m, "InferenceSession", R"pbdoc(
+      Inference path that doesn't modify the network. A session holds its own buffers and only reads the network's parameters, so several threads can each predict with their own session on the same network.
+
+      :param network: The network to predict with
+      :type network: Network
+
+      .. highlight: python
+      .. code-block:: python
+          :caption: Example
+
+          import NeuralNetPy as NNP
+
+          session = NNP.models.InferenceSession(network)
+          predictions = session.predict(inputs)
+
+      .. warning::
+          The network mustn't be trained while sessions are predicting with it.
+      )pbdoc")
+      .def(py::init<const Network &>(), py::arg("network"),
+           py::keep_alive<1, 2>())
+      .def(
+          "predict",
+          [](InferenceSession &session, const py::array &inputs) -> Matrix {
+            const py::array array = contiguousArray(inputs);
+            const ArrayView view = viewArray(array);
+            py::gil_scoped_release release;
+            return session.predict(view);
+          },
+          py::arg("inputs"), R"pbdoc(
+        Feed forward the given NumPy array through the network and return the predictions/outputs.
+
+        :param inputs: The inputs, one sample per element of the first axis (``float32``, ``float64`` or ``uint8``)
+        :type inputs: numpy.ndarray
+        :return: A matrix representing the outputs of the network for the given inputs
+        :rtype: numpy.ndarray
+      )pbdoc")
+      .def(
+          "predict",
+          [](InferenceSession &session,
+             const std::vector<std::vector<double>> &inputs) -> Matrix {
+            return session.predict(inputs);
+          },
+          py::arg("inputs"), py::call_guard<py::gil_scoped_release>(),
+          R"pbdoc(
+        Feed forward the given inputs through the network and return the predictions/outputs.
+
+        :param inputs: A list of vectors representing the inputs
+        :type inputs: list[list[float]]
+        :return: A matrix representing the outputs of the network for the given inputs
+        :rtype: numpy.ndarray
+      )pbdoc")
+      .def(
+          "predict",
+          [](InferenceSession &session,
+             const std::vector<std::vector<std::vector<double>>> &inputs)
+              -> Matrix { return session.predict(inputs); },
+          py::arg("inputs"), py::call_guard<py::gil_scoped_release>(),
+          R"pbdoc(
+        Feed forward the given inputs through the network (its input layer must be a ``Flatten`` layer) and return the predictions/outputs.
+
+        :param inputs: A list of 2D inputs
+        :type inputs: list[list[list[float]]]
+        :return: A matrix representing the outputs of the network for the given inputs
+        :rtype: numpy.ndarray
+      )pbdoc");
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include "data/ArrayTrainingData.hpp"
+#include "data/ArrayView.hpp"
+
+namespace py = pybind11;
+
+using namespace NeuralNet;
+
+/**
+ * Returns the array itself when it can be viewed as is (C-contiguous float32,
+ * float64 or uint8), otherwise a C-contiguous copy of it (ex: int64 labels or a
+ * transposed array), converted in a single NumPy operation.
+ */
+inline py::array contiguousArray(const py::array &array) {
+  constexpr int flags = py::array::c_style | py::array::forcecast;
+
+  if (py::isinstance<py::array_t<float>>(array))
+    return py::array_t<float, flags>::ensure(array);
+  if (py::isinstance<py::array_t<uint8_t>>(array))
+    return py::array_t<uint8_t, flags>::ensure(array);
+  return py::array_t<double, flags>::ensure(array);
+}
+
+/**
+ * Views a C-contiguous float32, float64 or uint8 array (see
+ * `contiguousArray`) as one flattened sample per row, without copying it.
+ */
+inline ArrayView viewArray(const py::array &array) {
+  if (!(array.flags() & py::array::c_style))
+    throw std::invalid_argument("The array must be C-contiguous");
+  if (array.ndim() == 0 || array.shape(0) == 0) return ArrayView();
+
+  DTYPE dtype = DTYPE::FLOAT64;
+  if (py::isinstance<py::array_t<float>>(array)) {
+    dtype = DTYPE::FLOAT32;
+  } else if (py::isinstance<py::array_t<uint8_t>>(array)) {
+    dtype = DTYPE::UINT8;
+  } else if (!py::isinstance<py::array_t<double>>(array)) {
+    throw std::invalid_argument("Unsupported array type");
+  }
+
+  const int rows = array.shape(0);
+  return ArrayView(array.data(), dtype, rows, array.size() / rows);
+}
+
+/**
+ * The arrays viewed by a `PyArrayTrainingData`, as a base class so that they
+ * are set before the views are made.
+ */
+struct ViewedArrays {
+  py::array xTrainArray, xTestArray;
+};
+
+/**
+ * `ArrayTrainingData` keeping the viewed NumPy arrays alive
+ */
+class PyArrayTrainingData : private ViewedArrays, public ArrayTrainingData {
+ public:
+  PyArrayTrainingData(const py::array &xTrain, const py::array &yTrain,
+                      const py::array &xTest, const py::array &yTest,
+                      double scale)
+      : ViewedArrays{contiguousArray(xTrain), contiguousArray(xTest)},
+        ArrayTrainingData(viewArray(xTrainArray),
+                          viewArray(contiguousArray(yTrain)),
+                          viewArray(xTestArray),
+                          viewArray(contiguousArray(yTest)), scale){};
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <array>
+#include <stdexcept>
+
+#include "callbacks/Callback.hpp"
+
+namespace py = pybind11;
+
+using namespace NeuralNet;
+
+/**
+ * Trampoline of the callbacks defined in Python.
+ *
+ * The training runs without the GIL, it's only acquired to call the hooks
+ * the Python class defines. Each hook is looked up once, so the hooks that
+ * aren't defined (ex: `onBatchEnd`) don't take the GIL at every batch.
+ */
+class PyCallback : public Callback {
+ public:
+  void onTrainBegin(Model &model) override { callHook(TRAIN_BEGIN, model); }
+  void onTrainEnd(Model &model) override { callHook(TRAIN_END, model); }
+  void onEpochBegin(Model &model) override { callHook(EPOCH_BEGIN, model); }
+  void onEpochEnd(Model &model) override { callHook(EPOCH_END, model); }
+  void onBatchBegin(Model &model) override { callHook(BATCH_BEGIN, model); }
+  void onBatchEnd(Model &model) override { callHook(BATCH_END, model); }
+
+ private:
+  enum Hook {
+    TRAIN_BEGIN,
+    TRAIN_END,
+    EPOCH_BEGIN,
+    EPOCH_END,
+    BATCH_BEGIN,
+    BATCH_END
+  };
+
+  static constexpr const char *hookNames[] = {
+      "onTrainBegin", "onTrainEnd",   "onEpochBegin",
+      "onEpochEnd",   "onBatchBegin", "onBatchEnd"};
+
+  // Whether each hook is defined in Python (-1 : not looked up yet)
+  std::array<int, 6> defined = {-1, -1, -1, -1, -1, -1};
+
+  void callHook(Hook hook, Model &model) {
+    if (defined[hook] == 0) return;
+
+    py::gil_scoped_acquire gil;
+    py::function override =
+        py::get_override(static_cast<const Callback *>(this), hookNames[hook]);
+    defined[hook] = static_cast<bool>(override);
+    if (!override) return;
+
+    try {
+      override(getLogs(model));
+    } catch (py::error_already_set &e) {
+      // Converted while the GIL is held, the training catches it without
+      // the GIL
+      throw std::runtime_error(e.what());
+    }
+  }
+};
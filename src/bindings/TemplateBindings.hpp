@@ -13,7 +13,13 @@ void bindTrainingData(py::module &m, const char *name, const char *docstring) {
       .def("batch", &TrainingData<Inputs, Labels>::batch, py::arg("batchSize"),
            py::arg("stratified") = false, py::arg("shuffle") = false,
            py::arg("dropLast") = false, py::arg("verbose") = false,
+           py::arg("reshuffle") = false, py::arg("seed") = 0,
            "This method will separate the inputs and labels data into batches "
-           "of the specified size")
+           "of the specified size. With ``reshuffle`` new batches are drawn at "
+           "each epoch, ``seed`` makes the shuffling reproducible.")
+      .def("prefetch", &TrainingData<Inputs, Labels>::prefetch,
+           py::arg("depth") = 2, py::arg("nWorkers") = 1,
+           "This method will make the training prepare the next ``depth`` "
+           "mini-batches on ``nWorkers`` background threads")
       .def("getMiniBatches", &TrainingData<Inputs, Labels>::getMiniBatches);
 };
\ No newline at end of file
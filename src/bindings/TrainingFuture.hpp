@@ -0,0 +1,94 @@
+#pragma once
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "Network.hpp"
+
+namespace py = pybind11;
+
+using namespace NeuralNet;
+
+/**
+ * Handle of a training running on a background thread (see
+ * `Network::trainAsync`). The GIL is released while waiting for it.
+ */
+class TrainingFuture {
+ public:
+  explicit TrainingFuture(std::future<double> future)
+      : future(std::move(future)){};
+
+  TrainingFuture(TrainingFuture &&) = default;
+
+  // The training keeps using the network, its data and its callbacks until
+  // it's over
+  ~TrainingFuture() {
+    if (!future.valid()) return;
+    py::gil_scoped_release release;
+    future.wait();
+  }
+
+  /**
+   * @brief Whether the training is over
+   */
+  bool done() const {
+    return future.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
+
+  /**
+   * @brief Waits for the training to be over
+   *
+   * @param timeout The maximum time to wait in seconds (none to wait for as
+   * long as needed)
+   *
+   * @return Whether the training is over
+   */
+  bool wait(std::optional<double> timeout) const {
+    py::gil_scoped_release release;
+    if (!timeout) {
+      future.wait();
+      return true;
+    }
+    return future.wait_for(std::chrono::duration<double>(*timeout)) ==
+           std::future_status::ready;
+  }
+
+  /**
+   * @brief Waits for the training to be over and get its loss
+   */
+  double result() const {
+    wait(std::nullopt);
+    return future.get();
+  }
+
+ private:
+  std::shared_future<double> future;
+};
+
+/**
+ * Binds `Network.trainAsync` for the given type of training data
+ */
+template <typename Data, typename PyClass>
+void bindTrainAsync(PyClass &network, const char *docstring) {
+  network.def(
+      "trainAsync",
+      [](Network &network, Data &trainingData, int epochs,
+         const std::vector<std::shared_ptr<Callback>> &callbacks,
+         bool progBar) {
+        return TrainingFuture(
+            network.trainAsync(trainingData, epochs, callbacks, progBar));
+      },
+      py::arg("trainingData"), py::arg("epochs"),
+      py::arg("callbacks") = std::vector<std::shared_ptr<Callback>>(),
+      py::arg("progBar") = true,
+      // The network, the data and the callbacks live as long as the handle
+      py::keep_alive<0, 1>(), py::keep_alive<0, 2>(), py::keep_alive<0, 4>(),
+      docstring);
+}
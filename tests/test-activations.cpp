@@ -83,6 +83,21 @@ TEST_CASE("Softmax activates correctly", "[function]") {
                       EPSILON);
 }
 
+TEST_CASE("Softmax is stable for large inputs", "[function]") {
+  MatrixXd inputs(2, 3);
+
+  inputs << 1000, 1000, -1000, -1000, 800, 801;
+
+  MatrixXd outputs = NeuralNet::Softmax::activate(inputs);
+
+  MatrixXd expectedOutputs(2, 3);
+
+  expectedOutputs << 0.5, 0.5, 0, 0, 0.26894142, 0.73105858;
+
+  CHECK_FALSE(outputs.array().isNaN().any());
+  CHECK_MATRIX_APPROX(outputs, expectedOutputs, EPSILON);
+}
+
 // TEST_CASE("Softmax differentiates correctly", "[function]")
 // {
 //   MatrixXd inputs(4, 1);
@@ -97,4 +112,40 @@ TEST_CASE("Softmax activates correctly", "[function]") {
 
 //   CHECK_MATRIX_APPROX(NeuralNet::Softmax::diff(activatedInputs),
 //   expectedOutputs, EPSILON);
-// }
\ No newline at end of file
+// }
+TEST_CASE("Fused backward passes match the derivatives", "[function]") {
+  MatrixXd z = MatrixXd::Random(5, 3);
+  MatrixXd grad = MatrixXd::Random(5, 3);
+  MatrixXd delta(5, 3);
+
+  SECTION("Relu") {
+    MatrixXd a = NeuralNet::Relu::activate(z);
+    NeuralNet::Relu::backward(a, grad, delta);
+    CHECK(delta == MatrixXd(grad.array() * NeuralNet::Relu::diff(a).array()));
+  }
+
+  SECTION("Sigmoid") {
+    MatrixXd a = NeuralNet::Sigmoid::activate(z);
+    NeuralNet::Sigmoid::backward(a, grad, delta);
+    CHECK_MATRIX_APPROX(
+        delta, grad.array() * NeuralNet::Sigmoid::diff(a).array(), 1e-12);
+  }
+
+  SECTION("Softmax") {
+    MatrixXd a = NeuralNet::Softmax::activate(z);
+    NeuralNet::Softmax::backward(a, grad, delta);
+
+    // Each row's gradient goes through the row's jacobian diag(a) - a'a
+    MatrixXd expected(5, 3);
+    for (int r = 0; r < 5; r++) {
+      MatrixXd jacobian = MatrixXd(a.row(r).asDiagonal()) -
+                          a.row(r).transpose() * a.row(r);
+      expected.row(r) = grad.row(r) * jacobian;
+    }
+    CHECK_MATRIX_APPROX(delta, expected, 1e-12);
+
+    // In place
+    NeuralNet::Softmax::backward(a, grad, grad);
+    CHECK_MATRIX_APPROX(grad, expected, 1e-12);
+  }
+}
@@ -0,0 +1,410 @@
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <catch2/catch_test_macros.hpp>
+#include <data/ArrayTrainingData.hpp>
+#include <data/BatchPrefetcher.hpp>
+#include <data/DatasetFile.hpp>
+#include <data/MappedTrainingData.hpp>
+#include <data/TrainingData.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace NeuralNet;
+
+SCENARIO("TrainingData batches samples by index") {
+  std::vector<std::vector<double>> inputs = {
+      {0, 0}, {1, 1}, {2, 2}, {3, 3}, {4, 4}};
+  std::vector<double> labels = {0, 1, 0, 1, 0};
+
+  TrainingData trainingData(inputs, labels);
+
+  WHEN("Batched without shuffling") {
+    trainingData.batch(2);
+
+    THEN("The last batch holds the remaining samples") {
+      REQUIRE(trainingData.getNumBatches() == 3);
+      CHECK(trainingData.getBatchSize(0) == 2);
+      CHECK(trainingData.getBatchSize(2) == 1);
+    }
+
+    THEN("The inputs are gathered in order") {
+      Eigen::MatrixXd x;
+      Eigen::MatrixXd expected(2, 2);
+
+      expected << 2, 2, 3, 3;
+
+      trainingData.gatherInputs(1, x);
+
+      CHECK(x == expected);
+    }
+
+    THEN("The labels are gathered and formatted") {
+      Eigen::MatrixXd y;
+      Eigen::MatrixXd expected(2, 2);
+
+      expected << 1, 0, 0, 1;
+
+      trainingData.gatherLabels(1, y, 2);
+
+      CHECK(y == expected);
+    }
+
+    THEN("The mini-batches can still be retrieved") {
+      auto miniBatches = trainingData.getMiniBatches();
+
+      REQUIRE(miniBatches.size() == 3);
+      CHECK(miniBatches[2].first == std::vector<std::vector<double>>{{4, 4}});
+      CHECK(miniBatches[2].second == std::vector<double>{0});
+    }
+  }
+
+  WHEN("Batched with dropLast") {
+    trainingData.batch(2, false, false, true);
+
+    THEN("The incomplete batch is dropped") {
+      CHECK(trainingData.getNumBatches() == 2);
+    }
+  }
+
+  WHEN("Batched with shuffling") {
+    trainingData.batch(2, false, true);
+
+    THEN("Every sample is still batched exactly once") {
+      Eigen::MatrixXd x;
+      std::vector<double> seen;
+
+      for (int b = 0; b < trainingData.getNumBatches(); b++) {
+        trainingData.gatherInputs(b, x);
+        for (int i = 0; i < x.rows(); i++) seen.push_back(x(i, 0));
+      }
+
+      std::sort(seen.begin(), seen.end());
+
+      CHECK(seen == std::vector<double>{0, 1, 2, 3, 4});
+    }
+  }
+}
+
+TEST_CASE("TrainingData flattens 3 dimensional inputs", "[data]") {
+  std::vector<std::vector<std::vector<double>>> inputs = {
+      {{1, 2}, {3, 4}}, {{5, 6}, {7, 8}}, {{9, 10}, {11, 12}}};
+  std::vector<double> labels = {0, 1, 2};
+
+  TrainingData trainingData(inputs, labels);
+
+  trainingData.batch(2);
+
+  Eigen::MatrixXd x;
+  Eigen::MatrixXd expected(2, 4);
+
+  expected << 1, 2, 3, 4, 5, 6, 7, 8;
+
+  trainingData.gatherInputs(0, x);
+
+  CHECK(x == expected);
+  CHECK(trainingData.getMiniBatches()[1].first[0] == inputs[2]);
+}
+
+TEST_CASE("TrainingData stratified batches keep every class", "[data]") {
+  std::vector<std::vector<double>> inputs = {{0}, {1}, {2}, {3}, {4}, {5}};
+  std::vector<double> labels = {0, 0, 0, 1, 1, 1};
+
+  TrainingData trainingData(inputs, labels);
+
+  trainingData.batch(2, true);
+
+  Eigen::MatrixXd y;
+
+  REQUIRE(trainingData.getNumBatches() == 3);
+
+  for (int b = 0; b < trainingData.getNumBatches(); b++) {
+    trainingData.gatherLabels(b, y, 2);
+    CHECK(y.colwise().sum() == Eigen::RowVector2d(1, 1));
+  }
+}
+
+TEST_CASE("TrainingData reshuffles its batches at each epoch", "[data]") {
+  std::vector<std::vector<double>> inputs;
+  std::vector<double> labels;
+
+  for (int i = 0; i < 100; i++) {
+    inputs.push_back({static_cast<double>(i)});
+    labels.push_back(i % 2);
+  }
+
+  TrainingData first(inputs, labels);
+  TrainingData second(inputs, labels);
+
+  first.batch(10, false, true, false, false, true, 42);
+  second.batch(10, false, true, false, false, true, 42);
+
+  Eigen::MatrixXd xFirst, xSecond, xPrevious;
+
+  first.gatherInputs(0, xPrevious);
+  first.nextEpoch();
+  second.nextEpoch();
+
+  first.gatherInputs(0, xFirst);
+  second.gatherInputs(0, xSecond);
+
+  // Same seed, same batches
+  CHECK(xFirst == xSecond);
+  // New epoch, new batches
+  CHECK(xFirst != xPrevious);
+}
+
+TEST_CASE("BatchPrefetcher hands out the batches in order", "[data]") {
+  std::vector<std::vector<double>> inputs;
+  std::vector<double> labels;
+
+  for (int i = 0; i < 50; i++) {
+    inputs.push_back({static_cast<double>(i), static_cast<double>(-i)});
+    labels.push_back(i % 3);
+  }
+
+  TrainingData trainingData(inputs, labels);
+
+  trainingData.batch(8, false, true);
+
+  BatchPrefetcher prefetcher(trainingData, 3, 3, 2);
+  Eigen::MatrixXd x, y;
+
+  for (int epoch = 0; epoch < 2; epoch++) {
+    prefetcher.startEpoch();
+
+    for (int b = 0; b < trainingData.getNumBatches(); b++) {
+      Batch &batch = prefetcher.acquire();
+
+      trainingData.gatherInputs(b, x);
+      trainingData.gatherLabels(b, y, 3);
+
+      CHECK(batch.x == x);
+      CHECK(batch.y == y);
+
+      prefetcher.release();
+    }
+  }
+}
+
+SCENARIO("MappedTrainingData batches samples out of a dataset file") {
+  std::vector<std::vector<std::vector<double>>> inputs = {
+      {{0, 1}, {2, 3}}, {{4, 5}, {6, 7}}, {{8, 9}, {10, 11}},
+      {{12, 13}, {14, 15}}, {{16, 17}, {18, 19}}};
+  std::vector<double> labels = {0, 1, 2, 1, 0};
+  const std::string path = "test-dataset.nnds";
+
+  TrainingData trainingData(inputs, labels);
+
+  WHEN("The samples are stored as float32") {
+    DatasetFile::write(path, inputs, labels);
+    MappedTrainingData mappedData(path);
+
+    trainingData.batch(2);
+    mappedData.batch(2);
+
+    THEN("The batches are the same as the in memory ones") {
+      Eigen::MatrixXd x, y, mappedX, mappedY;
+
+      REQUIRE(mappedData.getNumBatches() == trainingData.getNumBatches());
+
+      for (int b = 0; b < trainingData.getNumBatches(); b++) {
+        trainingData.gatherInputs(b, x);
+        trainingData.gatherLabels(b, y, 3);
+        mappedData.gatherInputs(b, mappedX);
+        mappedData.gatherLabels(b, mappedY, 3);
+
+        CHECK(mappedX == x);
+        CHECK(mappedY == y);
+      }
+    }
+  }
+
+  WHEN("The samples are stored as float64") {
+    DatasetFile::write(path, inputs, labels, DTYPE::FLOAT64);
+    MappedTrainingData mappedData(path);
+
+    mappedData.batch(5);
+
+    THEN("The samples are read back as they were") {
+      Eigen::MatrixXd x;
+      mappedData.gatherInputs(0, x);
+
+      CHECK(x(1, 3) == 7);
+      CHECK(x(4, 0) == 16);
+    }
+  }
+
+  WHEN("The samples are stored as uint8 and scaled") {
+    DatasetFile::write(path, inputs, labels, DTYPE::UINT8);
+    MappedTrainingData mappedData(path, "", 0.5);
+
+    mappedData.batch(2, true);
+
+    THEN("The samples are scaled when gathered") {
+      Eigen::MatrixXd x;
+      double sum = 0;
+
+      for (int b = 0; b < mappedData.getNumBatches(); b++) {
+        mappedData.gatherInputs(b, x);
+        sum += x.sum();
+      }
+
+      CHECK(sum == 0.5 * 190);
+    }
+  }
+
+  std::remove(path.c_str());
+}
+
+SCENARIO("ArrayTrainingData batches samples out of external arrays") {
+  // 5 samples of 2x2 values, as a NumPy array of shape (5, 2, 2) would be
+  std::vector<uint8_t> pixels(20);
+  std::iota(pixels.begin(), pixels.end(), 0);
+  std::vector<int> labelValues = {0, 1, 2, 1, 0};
+  std::vector<double> labels(labelValues.begin(), labelValues.end());
+
+  ArrayView x(pixels.data(), DTYPE::UINT8, 5, 4);
+  ArrayView y(labels.data(), DTYPE::FLOAT64, 5, 1);
+  ArrayTrainingData arrayData(x, y, x, y, 0.5);
+
+  arrayData.batch(2);
+
+  THEN("The batches are read from the arrays and scaled") {
+    Eigen::MatrixXd inputs, outputs;
+    Eigen::MatrixXd expectedInputs(2, 4), expectedOutputs(2, 3);
+
+    expectedInputs << 4, 4.5, 5, 5.5, 6, 6.5, 7, 7.5;
+    expectedOutputs << 0, 0, 1, 0, 1, 0;
+
+    arrayData.gatherInputs(1, inputs);
+    arrayData.gatherLabels(1, outputs, 3);
+
+    CHECK(inputs == expectedInputs);
+    CHECK(outputs == expectedOutputs);
+  }
+
+  THEN("The samples aren't copied") {
+    Eigen::MatrixXd inputs;
+    pixels[0] = 100;
+
+    arrayData.gatherInputs(0, inputs);
+
+    CHECK(inputs(0, 0) == 50);
+  }
+
+  THEN("The test data is gathered as a whole") {
+    REQUIRE(arrayData.hasTestData());
+    Eigen::MatrixXd inputs, outputs;
+
+    arrayData.gatherTestData(inputs, outputs, 3);
+
+    CHECK(inputs.rows() == 5);
+    CHECK(outputs.row(2) == Eigen::RowVector3d(0, 0, 1));
+  }
+
+  THEN("Mismatched inputs and labels are rejected") {
+    CHECK_THROWS(ArrayTrainingData(x, ArrayView(labels.data(), DTYPE::FLOAT64,
+                                                4, 1)));
+  }
+
+  THEN("Invalid class labels are rejected") {
+    for (double invalid : {-1.0, 0.5}) {
+      std::vector<double> invalidLabels = labels;
+      invalidLabels[3] = invalid;
+      CHECK_THROWS_AS(
+          ArrayTrainingData(x, ArrayView(invalidLabels.data(), DTYPE::FLOAT64,
+                                         5, 1)),
+          std::invalid_argument);
+    }
+
+    // Classes up to 2, the network only has 2 outputs
+    Eigen::MatrixXd outputs;
+    CHECK_THROWS_AS(arrayData.gatherLabels(0, outputs, 2),
+                    std::invalid_argument);
+    CHECK_THROWS_AS(arrayData.gatherTestData(outputs, outputs, 2),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("DatasetFile rejects invalid files", "[data]") {
+  const std::string path = "test-invalid.nnds";
+  std::ofstream(path) << "Not a dataset";
+
+  CHECK_THROWS(DatasetFile(path));
+  CHECK_THROWS(DatasetFile("missing.nnds"));
+
+  std::remove(path.c_str());
+}
+
+/**
+ * Writes a small dataset file, then overwrites its header with the modified
+ * one
+ */
+void writeCorrupted(const std::string &path,
+                    void (*corrupt)(DatasetFile::Header &),
+                    std::vector<double> labels = {0, 1}) {
+  DatasetFile::write(path, std::vector<std::vector<double>>{{1, 2}, {3, 4}},
+                     labels);
+
+  DatasetFile::Header header;
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.read(reinterpret_cast<char *>(&header), sizeof(header));
+  corrupt(header);
+  file.seekp(0);
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+}
+
+TEST_CASE("DatasetFile rejects inconsistent headers and labels", "[data]") {
+  const std::string path = "test-corrupted.nnds";
+
+  writeCorrupted(path, [](DatasetFile::Header &) {});
+  CHECK_NOTHROW(DatasetFile(path));
+
+  writeCorrupted(path, [](DatasetFile::Header &h) { h.dtype = 7; });
+  CHECK_THROWS_AS(DatasetFile(path), std::runtime_error);
+
+  writeCorrupted(path, [](DatasetFile::Header &h) { h.labelSize = 0; });
+  CHECK_THROWS_AS(DatasetFile(path), std::runtime_error);
+
+  // nSamples * sampleBytes overflows 64 bits
+  writeCorrupted(path, [](DatasetFile::Header &h) {
+    h.nSamples = uint64_t(1) << 62;
+    h.rows = h.cols = 1 << 16;
+  });
+  CHECK_THROWS_AS(DatasetFile(path), std::runtime_error);
+
+  writeCorrupted(path, [](DatasetFile::Header &) {}, {0, -1});
+  CHECK_THROWS_AS(DatasetFile(path), std::runtime_error);
+
+  writeCorrupted(path, [](DatasetFile::Header &) {}, {0, 1.5});
+  CHECK_THROWS_AS(DatasetFile(path), std::runtime_error);
+
+  // The class indexes are checked against the number of outputs
+  writeCorrupted(path, [](DatasetFile::Header &) {}, {0, 3});
+  DatasetFile file(path);
+  Eigen::MatrixXd y(1, 3);
+  CHECK_THROWS_AS(file.readLabel(1, y, 0), std::runtime_error);
+
+  std::remove(path.c_str());
+}
+
+TEST_CASE("MappedTrainingData rejects test samples of another size") {
+  const std::string trainPath = "test-train.nnds";
+  const std::string testPath = "test-test.nnds";
+
+  DatasetFile::write(trainPath,
+                     std::vector<std::vector<double>>{{1, 2}, {3, 4}},
+                     std::vector<double>{0, 1});
+  DatasetFile::write(testPath, std::vector<std::vector<double>>{{1, 2, 3}},
+                     std::vector<double>{0});
+
+  CHECK_THROWS_AS(MappedTrainingData(trainPath, testPath), std::runtime_error);
+  CHECK_NOTHROW(MappedTrainingData(trainPath, trainPath));
+
+  std::remove(trainPath.c_str());
+  std::remove(testPath.c_str());
+}
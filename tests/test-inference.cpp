@@ -0,0 +1,161 @@
+#include <InferenceSession.hpp>
+#include <Network.hpp>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "test-macros.hpp"
+
+using namespace NeuralNet;
+
+TEST_CASE("Inference session matches the layers computation", "[inference]") {
+  Network network;
+  network.setup(std::make_shared<SGD>(1), LOSS::MCE);
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(3);
+  std::shared_ptr<Layer> hiddenLayer =
+      std::make_shared<Dense>(4, ACTIVATION::SIGMOID, WEIGHT_INIT::GLOROT);
+  std::shared_ptr<Layer> dropoutLayer = std::make_shared<Dropout>(0.5, 42);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(2, ACTIVATION::SOFTMAX, WEIGHT_INIT::GLOROT);
+
+  network.addLayer(inputLayer);
+  network.addLayer(hiddenLayer);
+  network.addLayer(dropoutLayer);
+  network.addLayer(outputLayer);
+
+  Eigen::MatrixXd x = Eigen::MatrixXd::Random(5, 3);
+
+  InferenceSession session(network);
+  const Matrix &outputs = session.predict(x);
+
+  // The dropout layer is skipped
+  std::shared_ptr<Dense> hidden = std::dynamic_pointer_cast<Dense>(hiddenLayer);
+  std::shared_ptr<Dense> output = std::dynamic_pointer_cast<Dense>(outputLayer);
+  Eigen::MatrixXd z1 = x * hidden->getWeights();
+  z1.rowwise() += hidden->getBiases().row(0);
+  Eigen::MatrixXd z2 = Sigmoid::activate(z1) * output->getWeights();
+  z2.rowwise() += output->getBiases().row(0);
+
+  CHECK_MATRIX_APPROX(outputs, Softmax::activate(z2), 1e-12);
+
+  // The layers themselves aren't fed
+  CHECK(hiddenLayer->getOutputs().size() == 0);
+  CHECK(outputLayer->getOutputs().size() == 0);
+  CHECK(std::dynamic_pointer_cast<Dropout>(dropoutLayer)->mask.size() == 0);
+}
+
+TEST_CASE("Several threads can predict with the same network concurrently",
+          "[inference]") {
+  Network network;
+  network.setup(std::make_shared<SGD>(1), LOSS::MCE);
+
+  std::shared_ptr<Layer> inputLayer =
+      std::make_shared<Flatten>(std::make_tuple(4, 4));
+  std::shared_ptr<Layer> dropoutLayer = std::make_shared<Dropout>(0.5, 42);
+  std::shared_ptr<Layer> hiddenLayer =
+      std::make_shared<Dense>(32, ACTIVATION::RELU, WEIGHT_INIT::HE);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(10, ACTIVATION::SOFTMAX, WEIGHT_INIT::LECUN);
+
+  network.addLayer(inputLayer);
+  network.addLayer(dropoutLayer);
+  network.addLayer(hiddenLayer);
+  network.addLayer(outputLayer);
+
+  std::vector<std::vector<std::vector<double>>> inputs;
+  for (int i = 0; i < 8; i++) {
+    inputs.push_back(std::vector<std::vector<double>>(4));
+    for (int r = 0; r < 4; r++) {
+      for (int c = 0; c < 4; c++) inputs[i][r].push_back((i + r * c) * 0.1);
+    }
+  }
+
+  const Matrix expected = network.predict(inputs);
+  std::atomic<int> nMismatches{0};
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&, t] {
+      InferenceSession session(network);
+      for (int i = 0; i < 50; i++) {
+        // Alternating between the sessions and `Network::predict`
+        if ((i + t) % 2 == 0) {
+          if (session.predict(inputs) != expected) nMismatches++;
+        } else {
+          if (network.predict(inputs) != expected) nMismatches++;
+        }
+      }
+    });
+  }
+
+  for (std::thread &thread : threads) thread.join();
+
+  CHECK(nMismatches == 0);
+}
+
+TEST_CASE("Inference session follows the layers added after it",
+          "[inference]") {
+  Network network;
+  network.setup(std::make_shared<SGD>(1), LOSS::QUADRATIC);
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(3);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(2, ACTIVATION::SIGMOID, WEIGHT_INIT::GLOROT);
+
+  network.addLayer(inputLayer);
+  InferenceSession session(network);
+  network.addLayer(outputLayer);
+
+  const Matrix x = Matrix::Random(4, 3);
+
+  InferenceSession freshSession(network);
+
+  CHECK(session.predict(x) == freshSession.predict(x));
+}
+
+TEST_CASE("Predicting vectors checks the samples size", "[inference]") {
+  Network network;
+  network.setup(std::make_shared<SGD>(1), LOSS::QUADRATIC);
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(3);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(2, ACTIVATION::SIGMOID, WEIGHT_INIT::GLOROT);
+
+  network.addLayer(inputLayer);
+  network.addLayer(outputLayer);
+
+  std::vector<std::vector<double>> samples = {{0.1, 0.2, 0.3},
+                                              {0.4, 0.5, 0.6}};
+  // The same samples passed as columns
+  std::vector<std::vector<double>> columns = {{0.1, 0.4}, {0.2, 0.5},
+                                              {0.3, 0.6}};
+
+  CHECK(network.predict(columns) == network.predict(samples));
+  CHECK_THROWS_AS(network.predict(std::vector<std::vector<double>>{{0.1, 0.2}}),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(
+      network.predict(std::vector<std::vector<double>>{{0.1, 0.2, 0.3}, {0.4}}),
+      std::invalid_argument);
+  CHECK_THROWS_AS(network.predict(std::vector<std::vector<std::vector<double>>>{
+                      {{0.1, 0.2, 0.3}}}),
+                  std::invalid_argument);
+
+  // The session checks its inputs the same way
+  InferenceSession session(network);
+
+  CHECK(session.predict(columns) == session.predict(samples));
+  CHECK_THROWS_AS(session.predict(std::vector<std::vector<double>>()),
+                  std::invalid_argument);
+  CHECK_THROWS_AS(
+      session.predict(std::vector<std::vector<double>>{{0.1, 0.2, 0.3}, {0.4}}),
+      std::invalid_argument);
+  CHECK_THROWS_AS(session.predict(Matrix::Zero(2, 4)), std::invalid_argument);
+  CHECK_THROWS_AS(session.predict(Matrix::Zero(0, 3)), std::invalid_argument);
+  CHECK_THROWS_AS(session.predict(std::vector<std::vector<std::vector<double>>>{
+                      {{0.1, 0.2, 0.3}}}),
+                  std::invalid_argument);
+}
@@ -1,10 +1,13 @@
 #include <Eigen/Dense>
 #include <Network.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <layers/Dropout.hpp>
+#include <tuple>
 #include <utils/Functions.hpp>
 #include <vector>
 
+using namespace Catch::Matchers;
 using namespace NeuralNet;
 
 TEST_CASE("Flatten's flatten() works as expected", "[layer]") {
@@ -23,34 +26,30 @@ TEST_CASE("Flatten's flatten() works as expected", "[layer]") {
 };
 
 TEST_CASE("Dropout layer", "[layer]") {
-  double rate = 0.5;
+  double rate = 0.25;
   Dropout dropoutLayer = Dropout(rate);
 
   WHEN("Small inputs matrix") {
-    Eigen::MatrixXd inputs = Eigen::MatrixXd::Constant(4, 4, 1);
+    Eigen::MatrixXd inputs = Eigen::MatrixXd::Random(4, 4);
 
     Eigen::MatrixXd outputs = dropoutLayer.feedInputs(inputs);
 
-    int count = 0;
+    // Dropped inputs are zeroed, the others scaled up by 1 / (1 - rate)
+    REQUIRE_THAT(dropoutLayer.scaleRate, WithinAbs(1 / (1 - rate), 1e-6));
     for (int i = 0; i < outputs.rows(); i++) {
       for (int j = 0; j < outputs.cols(); j++) {
-        if (outputs(i, j) == 0) {
-          count++;
-        }
+        const double expected =
+            dropoutLayer.mask(i, j) ? inputs(i, j) * dropoutLayer.scaleRate : 0;
+        CHECK(outputs(i, j) == expected);
       }
     }
-
-    REQUIRE(count ==
-            static_cast<int>((1 - rate) * inputs.rows() * inputs.cols()));
-
-    // Test scale factor
-    CHECK(inputs.sum() == outputs.sum());
   }
 
   WHEN("Large inputs matrix") {
-    Eigen::MatrixXd inputs = Eigen::MatrixXd::Constant(30, 30, 1);
+    Eigen::MatrixXd inputs = Eigen::MatrixXd::Constant(300, 300, 1);
 
     Eigen::MatrixXd outputs = dropoutLayer.feedInputs(inputs);
+    const MaskMatrix firstMask = dropoutLayer.mask;
 
     int count = 0;
     for (int i = 0; i < outputs.rows(); i++) {
@@ -61,9 +60,101 @@ TEST_CASE("Dropout layer", "[layer]") {
       }
     }
 
-    REQUIRE(count == static_cast<int>(rate * inputs.rows() * inputs.cols()));
+    // Each input is dropped independently with a probability of rate
+    REQUIRE_THAT(static_cast<double>(count) / inputs.size(),
+                 WithinAbs(rate, 0.01));
 
     // Test scale factor
-    CHECK(inputs.sum() == outputs.sum());
+    REQUIRE_THAT(outputs.mean(), WithinAbs(inputs.mean(), 0.02));
+
+    // A new mask is drawn for every batch
+    dropoutLayer.feedInputs(inputs);
+    CHECK(dropoutLayer.mask != firstMask);
+  }
+
+  WHEN("Seeded") {
+    Dropout seeded(rate, 42), other(rate, 42);
+    Eigen::MatrixXd inputs = Eigen::MatrixXd::Random(16, 16);
+
+    CHECK(seeded.feedInputs(inputs) == other.feedInputs(inputs));
+  }
+}
+
+TEST_CASE("Dense layer reuses its outputs buffer", "[layer]") {
+  Network network;
+  std::shared_ptr<Optimizer> optimizer = std::make_shared<SGD>(1);
+  network.setup(optimizer, LOSS::QUADRATIC);
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(3);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(2, ACTIVATION::SIGMOID);
+
+  network.addLayer(inputLayer);
+  network.addLayer(outputLayer);
+
+  Eigen::MatrixXd inputs(2, 3);
+  inputs << 1, 2, 3, 4, 5, 6;
+
+  Eigen::MatrixXd outputs = outputLayer->feedInputs(inputs);
+  const double *buffer = outputLayer->getOutputs().data();
+
+  // Same batch size, the buffer is written in place
+  inputs(0, 0) = -1;
+  const Eigen::MatrixXd &newOutputs = outputLayer->feedInputs(inputs);
+
+  CHECK(newOutputs.data() == buffer);
+  CHECK(newOutputs != outputs);
+}
+
+TEST_CASE("Dense layer's tiled forward pass matches the plain computation",
+          "[layer]") {
+  // All spanning several tiles, the last one being incomplete. The widest
+  // layers get tiles of less than 16 rows, down to a single row.
+  const std::vector<std::tuple<ACTIVATION, int, int>> cases = {
+      {ACTIVATION::SIGMOID, 64, 1000},
+      {ACTIVATION::RELU, 64, 1000},
+      {ACTIVATION::SOFTMAX, 1024, 100},
+      {ACTIVATION::RELU, 4096, 21},
+      {ACTIVATION::SOFTMAX, 20000, 3}};
+
+  for (const auto &[activation, nNeurons, nSamples] : cases) {
+    Network network;
+    std::shared_ptr<Optimizer> optimizer = std::make_shared<SGD>(1);
+    network.setup(optimizer, LOSS::QUADRATIC);
+
+    std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(20);
+    std::shared_ptr<Layer> outputLayer =
+        std::make_shared<Dense>(nNeurons, activation, WEIGHT_INIT::GLOROT);
+
+    network.addLayer(inputLayer);
+    network.addLayer(outputLayer);
+
+    Eigen::MatrixXd x = Eigen::MatrixXd::Random(nSamples, 20);
+    std::vector<std::vector<double>> inputs(nSamples, std::vector<double>(20));
+    for (int i = 0; i < nSamples; i++) {
+      for (int j = 0; j < 20; j++) inputs[i][j] = x(i, j);
+    }
+
+    Eigen::MatrixXd predictions = network.predict(inputs);
+
+    std::shared_ptr<Dense> dense =
+        std::dynamic_pointer_cast<Dense>(outputLayer);
+    Eigen::MatrixXd z = x * dense->getWeights();
+    z.rowwise() += dense->getBiases().row(0);
+
+    Eigen::MatrixXd expected;
+    switch (activation) {
+      case ACTIVATION::SIGMOID:
+        expected = Sigmoid::activate(z);
+        break;
+      case ACTIVATION::RELU:
+        expected = Relu::activate(z);
+        break;
+      default:
+        expected = Softmax::activate(z);
+    }
+
+    REQUIRE(predictions.rows() == nSamples);
+    CHECK(predictions.isApprox(expected, 1e-12));
   }
-}
\ No newline at end of file
+}
@@ -1,6 +1,7 @@
 #include <activations/activations.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
 #include <losses/losses.hpp>
 
 #include "test-macros.hpp"
@@ -52,4 +53,35 @@ TEST_CASE("Testing Binary Cross-Entropy with softmax activation", "[losses]") {
   bool hasNaN = grad.array().isNaN().any();
 
   CHECK_FALSE(hasNaN);
-}
\ No newline at end of file
+}
+TEST_CASE("Fused softmax + MCE loss matches the unfused computation",
+          "[losses]") {
+  Eigen::MatrixXd logits = Eigen::MatrixXd::Random(100, 4) * 5;
+  Eigen::MatrixXd y = Eigen::MatrixXd::Zero(100, 4);
+
+  for (int r = 0; r < y.rows(); r++) y(r, r % 4) = 1;
+
+  Eigen::MatrixXd prob = Softmax::activate(logits);
+
+  CHECK_THAT(SoftmaxMCE::cmpLoss(logits, y),
+             WithinRel(MCE::cmpLoss(prob, y), 1e-9));
+
+  Eigen::MatrixXd grad;
+  SoftmaxMCE::cmpLossGrad(prob, y, grad);
+
+  CHECK(grad == prob - y);
+}
+
+TEST_CASE("Fused softmax + MCE loss stays finite for large logits",
+          "[losses]") {
+  Eigen::MatrixXd logits(2, 3);
+  Eigen::MatrixXd y(2, 3);
+
+  logits << 1000, -1000, 0, -1000, 1000, 999;
+  y << 0, 1, 0, 0, 0, 1;
+
+  double loss = SoftmaxMCE::cmpLoss(logits, y);
+
+  // -log(softmax) = lse - z
+  CHECK_THAT(loss, WithinRel(2000 + 1 + std::log1p(std::exp(-1.0)), 1e-9));
+}
@@ -2,6 +2,8 @@
 #include <Network.hpp>
 #include <callbacks/ModelCheckpoint.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <cstdio>
 #include <filesystem>
 #include <utils/Functions.hpp>
 #include <utils/Variants.hpp>
@@ -11,6 +13,45 @@
 using namespace NeuralNet;
 namespace fs = std::filesystem;
 
+/**
+ * The samples the small network is trained on, exact in float32 so that they
+ * are the same once written to a dataset file. The last batch of 2 samples
+ * is smaller than the others
+ */
+const std::vector<std::vector<double>> sampleInputs = {
+    {0.5, 0.25, 1},      {0.75, 0.5, 0},     {1, 0.25, 0.5},
+    {-0.5, 0.25, -1},    {0.25, 0.125, 0.75}, {0.5, -0.75, 0.25},
+    {0.125, 0.125, 0.125}};
+const std::vector<double> sampleLabels = {1, 1, 0, 1, 0, 0, 1};
+
+/**
+ * Builds a small network (3 inputs, 2 outputs), the weights are initialized
+ * to constants so that every network starts from the same parameters
+ */
+void buildNetwork(Network &network) {
+  std::shared_ptr<Optimizer> optimizer = std::make_shared<SGD>(0.5);
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(3);
+  std::shared_ptr<Layer> hiddenLayer =
+      std::make_shared<Dense>(4, ACTIVATION::RELU, WEIGHT_INIT::CONSTANT);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(2, ACTIVATION::SIGMOID, WEIGHT_INIT::CONSTANT);
+
+  network.setup(optimizer, LOSS::QUADRATIC);
+  network.addLayer(inputLayer);
+  network.addLayer(hiddenLayer);
+  network.addLayer(outputLayer);
+}
+
+/**
+ * Checks that two networks built with buildNetwork have the same weights
+ */
+void checkSameWeights(const Network &network, const Network &other) {
+  for (int l = 1; l < 3; l++) {
+    CHECK(std::dynamic_pointer_cast<Dense>(network.getLayer(l))->getWeights() ==
+          std::dynamic_pointer_cast<Dense>(other.getLayer(l))->getWeights());
+  }
+}
+
 SCENARIO("Basic small network functions") {
   GIVEN("A small neural network") {
     Network sn;  // sn - small network
@@ -330,3 +371,207 @@ TEST_CASE("The model serializes the different types of layers correctly") {
     }
   }
 }
+
+SCENARIO("Prefetching the batches doesn't change the training") {
+  Network network, prefetchedNetwork;
+
+  buildNetwork(network);
+  buildNetwork(prefetchedNetwork);
+
+  TrainingData trainingData(sampleInputs, sampleLabels);
+  TrainingData prefetchedData(sampleInputs, sampleLabels);
+
+  trainingData.batch(2, false, true, false, false, true, 7);
+  prefetchedData.batch(2, false, true, false, false, true, 7);
+  prefetchedData.prefetch(2, 2);
+
+  network.train(trainingData, 3, {}, false);
+  prefetchedNetwork.train(prefetchedData, 3, {}, false);
+
+  checkSameWeights(network, prefetchedNetwork);
+}
+
+SCENARIO("TrainingData labels that don't match the network aren't trained on") {
+  // A third class or a negative one, the network only has 2 outputs
+  std::vector<std::vector<double>> invalidLabels = {sampleLabels,
+                                                    sampleLabels};
+  invalidLabels[0][0] = 2;
+  invalidLabels[1][0] = -1;
+
+  WHEN("The prefetched labels don't match the network") {
+    for (const std::vector<double> &invalid : invalidLabels) {
+      Network network, trainedNetwork;
+      buildNetwork(network);
+      buildNetwork(trainedNetwork);
+
+      TrainingData trainingData(sampleInputs, invalid);
+      trainingData.batch(2);
+      trainingData.prefetch(2, 2);
+
+      // The workers' error interrupts the training instead of aborting
+      trainedNetwork.train(trainingData, 3, {}, false);
+
+      checkSameWeights(network, trainedNetwork);
+    }
+  }
+
+  WHEN("The labels of the whole data don't match the network") {
+    for (const std::vector<double> &invalid : invalidLabels) {
+      Network network, trainedNetwork;
+      buildNetwork(network);
+      buildNetwork(trainedNetwork);
+
+      TrainingData trainingData(sampleInputs, invalid);
+      trainedNetwork.train(trainingData, 3, {}, false);
+
+      checkSameWeights(network, trainedNetwork);
+    }
+  }
+
+  WHEN("The test labels don't match the network") {
+    for (const std::vector<double> &invalid : invalidLabels) {
+      Network network, trainedNetwork;
+      buildNetwork(network);
+      buildNetwork(trainedNetwork);
+
+      TrainingData trainingData(sampleInputs, sampleLabels, sampleInputs,
+                                invalid);
+      trainingData.batch(2);
+      trainedNetwork.train(trainingData, 3, {}, false);
+
+      checkSameWeights(network, trainedNetwork);
+    }
+  }
+}
+
+SCENARIO("Training on a dataset file is the same as in memory") {
+  const std::string path = "test-network-dataset.nnds";
+
+  DatasetFile::write(path, sampleInputs, sampleLabels);
+
+  Network network, mappedNetwork;
+
+  buildNetwork(network);
+  buildNetwork(mappedNetwork);
+
+  TrainingData trainingData(sampleInputs, sampleLabels);
+  MappedTrainingData mappedData(path);
+
+  trainingData.batch(2, false, true, false, false, true, 3);
+  mappedData.batch(2, false, true, false, false, true, 3);
+
+  network.train(trainingData, 3, {}, false);
+  mappedNetwork.train(mappedData, 3, {}, false);
+
+  checkSameWeights(network, mappedNetwork);
+
+  std::remove(path.c_str());
+}
+
+SCENARIO("Training on arrays is the same as in memory") {
+  const int nSamples = sampleInputs.size();
+
+  // The samples as a contiguous row-major array (ex: a NumPy array)
+  std::vector<double> values;
+  for (const std::vector<double> &input : sampleInputs)
+    values.insert(values.end(), input.begin(), input.end());
+  ArrayView x(values.data(), DTYPE::FLOAT64, nSamples, 3);
+  ArrayView y(sampleLabels.data(), DTYPE::FLOAT64, nSamples, 1);
+
+  WHEN("The data is batched") {
+    Network network, arrayNetwork;
+    buildNetwork(network);
+    buildNetwork(arrayNetwork);
+
+    TrainingData trainingData(sampleInputs, sampleLabels);
+    ArrayTrainingData arrayData(x, y);
+
+    trainingData.batch(2, false, true, false, false, true, 3);
+    arrayData.batch(2, false, true, false, false, true, 3);
+
+    network.train(trainingData, 3, {}, false);
+    arrayNetwork.train(arrayData, 3, {}, false);
+
+    checkSameWeights(network, arrayNetwork);
+    CHECK(arrayNetwork.predict(x) == network.predict(sampleInputs));
+  }
+
+  WHEN("The data isn't batched") {
+    Network network, arrayNetwork;
+    buildNetwork(network);
+    buildNetwork(arrayNetwork);
+
+    TrainingData trainingData(sampleInputs, sampleLabels);
+    ArrayTrainingData arrayData(x, y);
+
+    network.train(trainingData, 3, {}, false);
+    arrayNetwork.train(arrayData, 3, {}, false);
+
+    checkSameWeights(network, arrayNetwork);
+  }
+
+  WHEN("The arrays are trained on like the vectors") {
+    Network network, arrayNetwork;
+    buildNetwork(network);
+    buildNetwork(arrayNetwork);
+
+    network.train(sampleInputs, sampleLabels, 3, {}, false);
+    arrayNetwork.train(x, y, 3, {}, false);
+
+    checkSameWeights(network, arrayNetwork);
+  }
+
+  WHEN("The prefetched labels don't match the network") {
+    Network network, arrayNetwork;
+    buildNetwork(network);
+    buildNetwork(arrayNetwork);
+
+    // A third class in the first batch, the network only has 2 outputs
+    std::vector<double> invalidLabels = sampleLabels;
+    invalidLabels[0] = 2;
+    ArrayTrainingData arrayData(
+        x, ArrayView(invalidLabels.data(), DTYPE::FLOAT64, nSamples, 1));
+    arrayData.batch(2);
+    arrayData.prefetch(2, 2);
+
+    // The workers' error interrupts the training instead of aborting
+    arrayNetwork.train(arrayData, 3, {}, false);
+
+    checkSameWeights(network, arrayNetwork);
+  }
+
+  THEN("Samples of the wrong size can't be predicted") {
+    Network network;
+    buildNetwork(network);
+
+    CHECK_THROWS(network.predict(ArrayView(values.data(), DTYPE::FLOAT64,
+                                           nSamples * 3, 1)));
+  }
+}
+
+SCENARIO("A softmax output layer trained with the MCE has a finite loss") {
+  // Large inputs saturate the softmax, log(0) isn't reached by the fused head
+  std::vector<std::vector<double>> inputs = {
+      {500, -300, 200}, {-400, 100, 600}, {300, 300, -500}, {-200, -600, 100}};
+  std::vector<double> labels = {2, 0, 1, 0};
+
+  Network network;
+
+  std::shared_ptr<Optimizer> optimizer = std::make_shared<SGD>(0.1);
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(3);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(3, ACTIVATION::SOFTMAX, WEIGHT_INIT::GLOROT);
+
+  network.setup(optimizer, LOSS::MCE);
+  network.addLayer(inputLayer);
+  network.addLayer(outputLayer);
+
+  double loss = network.train(inputs, labels, 3, {}, false);
+
+  CHECK(std::isfinite(loss));
+  CHECK(loss > 0);
+
+  Eigen::MatrixXd outputs = network.predict(inputs);
+
+  CHECK_FALSE(outputs.array().isNaN().any());
+}
@@ -1,7 +1,13 @@
 #include <Eigen/Dense>
+#include <Network.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <cmath>
 #include <iostream>
+#include <memory>
 #include <optimizers/optimizers.hpp>
+#include <vector>
+
+#include "test-macros.hpp"
 
 using namespace NeuralNet;
 
@@ -19,4 +25,183 @@ SCENARIO("Testing SGD Optimizer") {
       REQUIRE(weights == Eigen::MatrixXd::Zero(2, 2));
     };
   }
-}
\ No newline at end of file
+}
+
+SCENARIO("Testing SGD Optimizer with momentum") {
+  const double alpha = 0.1, momentum = 0.9;
+
+  GIVEN("Parameters and their gradients") {
+    Matrix param(2, 2), grad(2, 2);
+    param << 1, -2, 0.5, 3;
+    grad << 0.5, -1, 2, -0.25;
+
+    for (bool nesterov : {false, true}) {
+      SGD optimizer(alpha, momentum, nesterov);
+      Matrix p = param, velocity = Matrix::Zero(2, 2);
+      Matrix expected = param, vRef = Matrix::Zero(2, 2);
+
+      for (int t = 1; t <= 3; t++) {
+        optimizer.update(p, grad * t, velocity);
+
+        const Matrix g = grad * t;
+        vRef = momentum * vRef + g;
+        expected -= alpha * (nesterov ? Matrix(g + momentum * vRef) : vRef);
+      }
+
+      // Each step follows the algorithm
+      CHECK_MATRIX_APPROX(p, expected, 1e-12);
+      CHECK_MATRIX_APPROX(velocity, vRef, 1e-12);
+    }
+  }
+}
+
+SCENARIO("Testing Adam Optimizer") {
+  const double alpha = 0.01, beta1 = 0.9, beta2 = 0.999, epsilon = 1e-8;
+  Adam optimizer(alpha, beta1, beta2, epsilon);
+
+  GIVEN("Parameters and their gradients") {
+    Matrix param(3, 2), grad(3, 2);
+    param << 1, -2, 0.5, 3, -1, 0;
+    grad << 0.5, -1, 2, -0.25, 1e-3, 4;
+    Matrix m = Matrix::Zero(3, 2), v = Matrix::Zero(3, 2);
+
+    THEN("Each step follows the algorithm") {
+      Matrix expected = param, mRef = m, vRef = v;
+
+      for (int t = 1; t <= 3; t++) {
+        optimizer.update(param, grad * t, m, v);
+
+        const Matrix g = grad * t;
+        mRef = beta1 * mRef + (1 - beta1) * g;
+        vRef = beta2 * vRef + (1 - beta2) * g.cwiseProduct(g);
+        const double alphaT = alpha * std::sqrt(1 - std::pow(beta2, t)) /
+                              (1 - std::pow(beta1, t));
+        expected.array() -=
+            alphaT * mRef.array() / (vRef.array().sqrt() + epsilon);
+      }
+
+      CHECK_MATRIX_APPROX(param, expected, 1e-9);
+      CHECK_MATRIX_APPROX(m, mRef, 1e-9);
+      CHECK_MATRIX_APPROX(v, vRef, 1e-9);
+    }
+
+    THEN("The first step moves each parameter by the learning rate") {
+      const Matrix before = param;
+      optimizer.update(param, grad, m, v);
+
+      CHECK_MATRIX_APPROX(before - param, alpha * grad.array().sign().matrix(),
+                          1e-5);
+    }
+
+    THEN("Non contiguous parameters are updated like contiguous ones") {
+      Matrix block = param.topRows(2);
+      Adam other(alpha, beta1, beta2, epsilon);
+      Matrix mBlock = m.topRows(2), vBlock = v.topRows(2);
+
+      optimizer.update(param.topRows(2), grad.topRows(2), m.topRows(2),
+                       v.topRows(2));
+      other.update(block, grad.topRows(2), mBlock, vBlock);
+
+      CHECK(param.topRows(2) == block);
+      CHECK(m.topRows(2) == mBlock);
+    }
+  }
+}
+
+SCENARIO("Testing AdamW Optimizer") {
+  const double alpha = 0.1, weightDecay = 0.5;
+  AdamW optimizer(alpha, 0.9, 0.999, 1e-8, weightDecay);
+
+  GIVEN("Parameters without gradients") {
+    Matrix param = Matrix::Constant(2, 2, 2);
+    Matrix m = Matrix::Zero(2, 2), v = Matrix::Zero(2, 2);
+
+    THEN("The parameters only decay") {
+      optimizer.update(param, Matrix::Zero(2, 2), m, v);
+      optimizer.update(param, Matrix::Zero(2, 2), m, v);
+
+      const double decay = 1 - alpha * weightDecay;
+      CHECK_MATRIX_APPROX(param, Matrix::Constant(2, 2, 2 * decay * decay));
+    }
+  }
+}
+
+TEST_CASE("An optimizer only updates the network it was set up with",
+          "[optimizers]") {
+  std::vector<std::vector<double>> inputs = {{0, 1}, {1, 0}, {1, 1}};
+  std::vector<double> labels = {0, 1, 1};
+
+  for (std::shared_ptr<Optimizer> optimizer :
+       {std::shared_ptr<Optimizer>(std::make_shared<Adam>(0.01)),
+        std::shared_ptr<Optimizer>(std::make_shared<SGD>(0.1, 0.9))}) {
+    Network first, second;
+
+    for (Network *network : {&first, &second}) {
+      std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(2);
+      std::shared_ptr<Layer> outputLayer =
+          std::make_shared<Dense>(2, ACTIVATION::SIGMOID);
+      network->setup(optimizer, LOSS::QUADRATIC);
+      network->addLayer(inputLayer);
+      network->addLayer(outputLayer);
+    }
+
+    // The optimizer's state is laid out like the second network's parameters
+    const Matrix weights =
+        std::static_pointer_cast<Dense>(first.getLayer(1))->getWeights();
+    first.train(inputs, labels, 1, {}, false);
+
+    CHECK(std::static_pointer_cast<Dense>(first.getLayer(1))->getWeights() ==
+          weights);
+  }
+}
+
+TEST_CASE("Adam's bias corrections restart with its moments", "[optimizers]") {
+  const double alpha = 0.01;
+  std::vector<std::vector<double>> inputs = {{0, 1}, {1, 0}, {1, 1}};
+  std::vector<double> labels = {0, 1, 1};
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(inputs, labels);
+
+  std::shared_ptr<Optimizer> optimizer =
+      std::make_shared<Adam>(alpha, 0.9, 0.999, 1e-12);
+  Network network;
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(2);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(2, ACTIVATION::SIGMOID);
+  network.setup(optimizer, LOSS::QUADRATIC);
+  network.addLayer(inputLayer);
+  network.addLayer(outputLayer);
+  network.train(trainingData, 5, {}, false);
+
+  SECTION("Setting the network up again") {
+    network.setup(optimizer, LOSS::QUADRATIC);
+  }
+
+  SECTION("Adding a layer") {
+    std::shared_ptr<Layer> layer =
+        std::make_shared<Dense>(2, ACTIVATION::SIGMOID);
+    network.addLayer(layer);
+  }
+
+  std::vector<Matrix> before;
+  for (size_t l = 1; l < network.getNumLayers(); l++) {
+    const auto dense = std::static_pointer_cast<Dense>(network.getLayer(l));
+    before.push_back(dense->getWeights());
+    before.push_back(dense->getBiases());
+  }
+
+  network.train(trainingData, 1, {}, false);
+
+  // The first step of fresh moments moves each parameter by the learning rate
+  for (size_t l = 1; l < network.getNumLayers(); l++) {
+    const auto dense = std::static_pointer_cast<Dense>(network.getLayer(l));
+    const Matrix &weights = before[2 * (l - 1)], &biases = before[2 * l - 1];
+
+    CHECK_MATRIX_APPROX((dense->getWeights() - weights).cwiseAbs(),
+                        Matrix::Constant(weights.rows(), weights.cols(), alpha),
+                        1e-6);
+    CHECK_MATRIX_APPROX((dense->getBiases() - biases).cwiseAbs(),
+                        Matrix::Constant(biases.rows(), biases.cols(), alpha),
+                        1e-6);
+  }
+}
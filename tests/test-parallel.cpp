@@ -0,0 +1,343 @@
+#include <Network.hpp>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "test-macros.hpp"
+
+using namespace NeuralNet;
+
+/**
+ * Builds a small network (dropout and softmax head included) with the given
+ * training mode, the weights are initialized to constants so that every
+ * network starts from the same parameters
+ */
+std::shared_ptr<Network> buildNetwork(TRAINING_MODE mode, int nThreads,
+                                      std::shared_ptr<Optimizer> optimizer,
+                                      LOSS loss, bool withDropout = true) {
+  std::shared_ptr<Network> network = std::make_shared<Network>();
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(4);
+  std::shared_ptr<Layer> hiddenLayer =
+      std::make_shared<Dense>(6, ACTIVATION::SIGMOID, WEIGHT_INIT::CONSTANT);
+  std::shared_ptr<Layer> dropoutLayer = std::make_shared<Dropout>(0.25, 42);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(3, ACTIVATION::SOFTMAX, WEIGHT_INIT::CONSTANT);
+
+  network->addLayer(inputLayer);
+  network->addLayer(hiddenLayer);
+  if (withDropout) network->addLayer(dropoutLayer);
+  network->addLayer(outputLayer);
+  network->setup(optimizer, loss);
+  network->setTrainingMode(mode, nThreads);
+
+  return network;
+}
+
+/**
+ * Trains the network on a fixed dataset and returns the last epoch's loss
+ */
+double trainNetwork(Network &network, int epochs = 3,
+                    std::vector<std::shared_ptr<Callback>> callbacks = {}) {
+  std::vector<std::vector<double>> inputs;
+  std::vector<double> labels;
+
+  for (int i = 0; i < 23; i++) {
+    inputs.push_back({i * 0.1, -i * 0.05, (i % 5) * 0.3, (i % 2) * 0.5});
+    labels.push_back(i % 3);
+  }
+
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(inputs, labels);
+
+  // The last batch (3 samples) is smaller than the number of workers
+  trainingData.batch(5, false, true, false, false, true, 7);
+
+  return network.train(trainingData, epochs, callbacks, false);
+}
+
+std::shared_ptr<Network> trainNetwork(TRAINING_MODE mode, int nThreads,
+                                      std::shared_ptr<Optimizer> optimizer,
+                                      LOSS loss, bool withDropout = true) {
+  std::shared_ptr<Network> network =
+      buildNetwork(mode, nThreads, optimizer, loss, withDropout);
+  trainNetwork(*network);
+  return network;
+}
+
+ConstMatrixRef weightsOf(const Network &network, int l) {
+  return std::dynamic_pointer_cast<Dense>(network.getLayer(l))->getWeights();
+}
+
+ConstMatrixRef biasesOf(const Network &network, int l) {
+  return std::dynamic_pointer_cast<Dense>(network.getLayer(l))->getBiases();
+}
+
+TEST_CASE("Data-parallel training is deterministic for a number of threads",
+          "[parallel]") {
+  std::shared_ptr<Network> network = trainNetwork(
+      TRAINING_MODE::DATA_PARALLEL, 4, std::make_shared<Adam>(0.01), LOSS::MCE);
+  std::shared_ptr<Network> other = trainNetwork(
+      TRAINING_MODE::DATA_PARALLEL, 4, std::make_shared<Adam>(0.01), LOSS::MCE);
+
+  for (int l : {1, 3}) {
+    CHECK(weightsOf(*network, l) == weightsOf(*other, l));
+    CHECK(biasesOf(*network, l) == biasesOf(*other, l));
+  }
+}
+
+TEST_CASE("Data-parallel training matches the sequential training",
+          "[parallel]") {
+  for (LOSS loss : {LOSS::MCE, LOSS::QUADRATIC}) {
+    std::shared_ptr<Network> sequential =
+        trainNetwork(TRAINING_MODE::SEQUENTIAL, 1,
+                     std::make_shared<SGD>(0.5), loss);
+
+    for (int nThreads : {1, 2, 4}) {
+      std::shared_ptr<Network> parallel =
+          trainNetwork(TRAINING_MODE::DATA_PARALLEL, nThreads,
+                       std::make_shared<SGD>(0.5), loss);
+
+      for (int l : {1, 3}) {
+        CHECK_MATRIX_APPROX(weightsOf(*parallel, l), weightsOf(*sequential, l),
+                            1e-9);
+        CHECK_MATRIX_APPROX(biasesOf(*parallel, l), biasesOf(*sequential, l),
+                            1e-9);
+      }
+    }
+  }
+}
+
+TEST_CASE("HOGWILD training with one thread matches the sequential training",
+          "[parallel]") {
+  // The workers draw their own dropout masks, so without dropout layer
+  std::shared_ptr<Network> sequential =
+      trainNetwork(TRAINING_MODE::SEQUENTIAL, 1, std::make_shared<SGD>(0.5),
+                   LOSS::MCE, false);
+  std::shared_ptr<Network> hogwild =
+      trainNetwork(TRAINING_MODE::HOGWILD, 1, std::make_shared<SGD>(0.5),
+                   LOSS::MCE, false);
+
+  for (int l : {1, 2}) {
+    CHECK_MATRIX_APPROX(weightsOf(*hogwild, l), weightsOf(*sequential, l),
+                        1e-9);
+    CHECK_MATRIX_APPROX(biasesOf(*hogwild, l), biasesOf(*sequential, l),
+                        1e-9);
+  }
+}
+
+TEST_CASE("HOGWILD training with several threads converges", "[parallel]") {
+  setRandomSeed(42);
+
+  // Without dropout, the noise only comes from the concurrent updates
+  std::shared_ptr<Network> network = buildNetwork(
+      TRAINING_MODE::HOGWILD, 4, std::make_shared<SGD>(0.5), LOSS::MCE, false);
+
+  // Classes given away by the first two inputs, the sequential training gets
+  // from a loss of 1.2 to 0.07 in 100 epochs
+  std::vector<std::vector<double>> inputs;
+  std::vector<double> labels;
+
+  for (int i = 0; i < 23; i++) {
+    inputs.push_back({i % 3 == 0 ? 1. : 0, i % 3 == 1 ? 1. : 0,
+                      (i % 5) * 0.2, -0.5});
+    labels.push_back(i % 3);
+  }
+
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(inputs, labels);
+  trainingData.batch(5, false, true, false, false, true, 7);
+
+  const double loss = network->train(trainingData, 100, {}, false);
+
+  CHECK(std::isfinite(loss));
+  CHECK(loss < 0.3);
+}
+
+TEST_CASE("HOGWILD training requires the SGD optimizer", "[parallel]") {
+  CHECK_THROWS_AS(buildNetwork(TRAINING_MODE::HOGWILD, 2,
+                               std::make_shared<Adam>(0.01), LOSS::MCE),
+                  std::invalid_argument);
+
+  // Whether the optimizer is set before or after the training mode
+  Network network;
+  network.setTrainingMode(TRAINING_MODE::HOGWILD, 2);
+
+  CHECK_THROWS_AS(network.setup(std::make_shared<Adam>(0.01), LOSS::MCE),
+                  std::invalid_argument);
+}
+
+/**
+ * Counts the batch callbacks, the HOGWILD workers call them one at a time
+ */
+class BatchCounter : public Callback {
+ public:
+  int batchesBegun = 0, batchesEnded = 0;
+
+  void onTrainBegin(Model &model) override {}
+  void onTrainEnd(Model &model) override {}
+  void onEpochBegin(Model &model) override {}
+  void onEpochEnd(Model &model) override {}
+  void onBatchBegin(Model &model) override { batchesBegun++; }
+  void onBatchEnd(Model &model) override { batchesEnded++; }
+};
+
+TEST_CASE("HOGWILD training calls the batch callbacks", "[parallel]") {
+  std::shared_ptr<Network> network = buildNetwork(
+      TRAINING_MODE::HOGWILD, 4, std::make_shared<SGD>(0.5), LOSS::MCE);
+  std::shared_ptr<BatchCounter> counter = std::make_shared<BatchCounter>();
+
+  trainNetwork(*network, 3, {counter});
+
+  // 5 batches per epoch
+  CHECK(counter->batchesBegun == 15);
+  CHECK(counter->batchesEnded == 15);
+}
+
+TEST_CASE("HOGWILD training applies the per-epoch learning rate schedules",
+          "[parallel]") {
+  std::shared_ptr<Network> sequential = buildNetwork(
+      TRAINING_MODE::SEQUENTIAL, 1, std::make_shared<SGD>(0.5), LOSS::MCE,
+      false);
+  std::shared_ptr<Network> hogwild = buildNetwork(
+      TRAINING_MODE::HOGWILD, 1, std::make_shared<SGD>(0.5), LOSS::MCE, false);
+  sequential->setScheduler(std::make_shared<StepLR>(1, 0.5));
+  hogwild->setScheduler(std::make_shared<StepLR>(1, 0.5));
+
+  trainNetwork(*sequential);
+  trainNetwork(*hogwild);
+
+  for (int l : {1, 2}) {
+    CHECK_MATRIX_APPROX(weightsOf(*hogwild, l), weightsOf(*sequential, l),
+                        1e-9);
+    CHECK_MATRIX_APPROX(biasesOf(*hogwild, l), biasesOf(*sequential, l),
+                        1e-9);
+  }
+
+  // The workers can't share a rate changing at every batch
+  std::shared_ptr<Network> network = buildNetwork(
+      TRAINING_MODE::HOGWILD, 2, std::make_shared<SGD>(0.5), LOSS::MCE);
+
+  CHECK_THROWS_AS(
+      network->setScheduler(std::make_shared<CosineAnnealingLR>(10)),
+      std::invalid_argument);
+
+  std::shared_ptr<Network> sequentialNetwork = buildNetwork(
+      TRAINING_MODE::SEQUENTIAL, 2, std::make_shared<SGD>(0.5), LOSS::MCE);
+  sequentialNetwork->setScheduler(std::make_shared<CosineAnnealingLR>(10));
+
+  CHECK_THROWS_AS(sequentialNetwork->setTrainingMode(TRAINING_MODE::HOGWILD),
+                  std::invalid_argument);
+}
+
+TEST_CASE("Updating after the backpropagation gives the same parameters",
+          "[parallel]") {
+  for (int o = 0; o < 3; o++) {
+    auto makeOptimizer = [o]() -> std::shared_ptr<Optimizer> {
+      if (o == 0) return std::make_shared<SGD>(0.5);
+      if (o == 1) return std::make_shared<SGD>(0.1, 0.9, true);
+      return std::make_shared<Adam>(0.01);
+    };
+
+    std::shared_ptr<Network> perLayer = trainNetwork(
+        TRAINING_MODE::SEQUENTIAL, 1, makeOptimizer(), LOSS::MCE);
+
+    for (int nThreads : {1, 3}) {
+      std::shared_ptr<Network> afterBackprop = buildNetwork(
+          TRAINING_MODE::SEQUENTIAL, nThreads, makeOptimizer(), LOSS::MCE);
+      afterBackprop->setUpdateSchedule(UPDATE_SCHEDULE::AFTER_BACKPROP);
+      trainNetwork(*afterBackprop);
+
+      for (int l : {1, 3}) {
+        CHECK_MATRIX_APPROX(weightsOf(*afterBackprop, l),
+                            weightsOf(*perLayer, l), 1e-12);
+        CHECK_MATRIX_APPROX(biasesOf(*afterBackprop, l),
+                            biasesOf(*perLayer, l), 1e-12);
+      }
+    }
+  }
+}
+
+/**
+ * Records the thread the batch callbacks are called from
+ */
+class ThreadRecorder : public Callback {
+ public:
+  std::thread::id threadId;
+  int nBatches = 0;
+
+  void onTrainBegin(Model &model) override {};
+  void onTrainEnd(Model &model) override {};
+  void onEpochBegin(Model &model) override {};
+  void onEpochEnd(Model &model) override {};
+  void onBatchBegin(Model &model) override {};
+  void onBatchEnd(Model &model) override {
+    threadId = std::this_thread::get_id();
+    nBatches++;
+  };
+};
+
+TEST_CASE("Asynchronous training matches the synchronous training",
+          "[parallel]") {
+  std::vector<std::vector<double>> inputs;
+  std::vector<double> labels;
+
+  for (int i = 0; i < 23; i++) {
+    inputs.push_back({i * 0.1, -i * 0.05, (i % 5) * 0.3, (i % 2) * 0.5});
+    labels.push_back(i % 3);
+  }
+
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(inputs, labels);
+  trainingData.batch(5);
+
+  std::shared_ptr<Network> asyncNetwork =
+      buildNetwork(TRAINING_MODE::SEQUENTIAL, 1, std::make_shared<SGD>(0.5),
+                   LOSS::MCE, false);
+  std::shared_ptr<Network> syncNetwork =
+      buildNetwork(TRAINING_MODE::SEQUENTIAL, 1, std::make_shared<SGD>(0.5),
+                   LOSS::MCE, false);
+  const double loss = syncNetwork->train(trainingData, 3, {}, false);
+
+  std::shared_ptr<ThreadRecorder> recorder = std::make_shared<ThreadRecorder>();
+  std::future<double> future =
+      asyncNetwork->trainAsync(trainingData, 3, {recorder}, false);
+
+  CHECK(future.get() == loss);
+  CHECK(recorder->nBatches == 3 * 5);
+  CHECK(recorder->threadId != std::this_thread::get_id());
+
+  for (int l : {1, 2}) {
+    CHECK(weightsOf(*asyncNetwork, l) == weightsOf(*syncNetwork, l));
+    CHECK(biasesOf(*asyncNetwork, l) == biasesOf(*syncNetwork, l));
+  }
+}
+
+TEST_CASE("The worker pool rethrows the exceptions of its workers",
+          "[parallel]") {
+  WorkerPool pool(4);
+  std::atomic<int> nDone{0};
+
+  // Thrown by a worker thread, then by the calling thread
+  for (int thrower : {2, 0}) {
+    auto task = [&](int w) {
+      if (w == thrower) throw std::runtime_error("Worker failure");
+      nDone++;
+    };
+
+    nDone = 0;
+    CHECK_THROWS_AS(pool.run(task), std::runtime_error);
+    // Every other worker finished before the exception reached the caller
+    CHECK(nDone == 3);
+  }
+
+  // The pool is still usable afterwards
+  nDone = 0;
+  pool.run([&](int) { nDone++; });
+  CHECK(nDone == 4);
+}
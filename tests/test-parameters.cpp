@@ -0,0 +1,65 @@
+#include <Network.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+using namespace NeuralNet;
+
+bool isAligned(const Scalar *ptr) {
+  return reinterpret_cast<uintptr_t>(ptr) % 64 == 0;
+}
+
+std::shared_ptr<Dense> denseOf(const Network &network, int l) {
+  return std::static_pointer_cast<Dense>(network.getLayer(l));
+}
+
+TEST_CASE("The parameters of all the layers share a contiguous arena",
+          "[parameters]") {
+  Network network;
+
+  std::vector<std::shared_ptr<Layer>> layers = {
+      std::make_shared<Dense>(4),
+      std::make_shared<Dense>(5, ACTIVATION::RELU, WEIGHT_INIT::HE),
+      std::make_shared<Dropout>(0.25, 42),
+      std::make_shared<Dense>(3, ACTIVATION::SOFTMAX, WEIGHT_INIT::GLOROT)};
+
+  for (std::shared_ptr<Layer> &layer : layers) network.addLayer(layer);
+
+  const Scalar *w1 = denseOf(network, 1)->getWeights().data();
+  const Scalar *b1 = denseOf(network, 1)->getBiases().data();
+  const Scalar *w3 = denseOf(network, 3)->getWeights().data();
+  const Scalar *b3 = denseOf(network, 3)->getBiases().data();
+
+  // The blocks follow each other, padded to stay aligned
+  CHECK(b1 == w1 + ParameterArena::blockSize(4, 5));
+  CHECK(w3 == b1 + ParameterArena::blockSize(1, 5));
+  CHECK(b3 == w3 + ParameterArena::blockSize(5, 3));
+
+  for (const Scalar *block : {w1, b1, w3, b3}) CHECK(isAligned(block));
+
+  // The input layer has no parameters
+  CHECK(denseOf(network, 0)->getWeights().size() == 0);
+}
+
+TEST_CASE("Adding layers keeps the parameters of the previous ones",
+          "[parameters]") {
+  Network network;
+
+  std::vector<std::shared_ptr<Layer>> layers = {
+      std::make_shared<Dense>(4),
+      std::make_shared<Dense>(6, ACTIVATION::RELU, WEIGHT_INIT::HE, 1),
+      std::make_shared<Dense>(2, ACTIVATION::SIGMOID)};
+
+  network.addLayer(layers[0]);
+  network.addLayer(layers[1]);
+
+  const Matrix weights = denseOf(network, 1)->getWeights();
+  const Matrix biases = denseOf(network, 1)->getBiases();
+  CHECK(biases == Matrix::Constant(1, 6, 1));
+
+  network.addLayer(layers[2]);
+
+  CHECK(denseOf(network, 1)->getWeights() == weights);
+  CHECK(denseOf(network, 1)->getBiases() == biases);
+}
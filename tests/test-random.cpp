@@ -0,0 +1,146 @@
+#include <Network.hpp>
+#include <algorithm>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <cmath>
+#include <utils/Random.hpp>
+#include <utils/WorkerPool.hpp>
+#include <vector>
+
+using namespace Catch::Matchers;
+using namespace NeuralNet;
+
+TEST_CASE("Philox matches the reference values", "[random]") {
+  uint32_t words[4];
+
+  // Known answers of Philox4x32-10 (Random123)
+  Philox(0, 0).generate(0, 1, words);
+  CHECK(words[0] == 0x6627e8d5);
+  CHECK(words[1] == 0xe169c58d);
+  CHECK(words[2] == 0xbc57ac4c);
+  CHECK(words[3] == 0x9b00dbd8);
+
+  Philox(0x299f31d0a4093822, 0x0370734413198a2e)
+      .generate(0x85a308d3243f6a88, 1, words);
+  CHECK(words[0] == 0xd16cfe09);
+  CHECK(words[1] == 0x94fdcceb);
+  CHECK(words[2] == 0x5001e420);
+  CHECK(words[3] == 0x24126ea1);
+}
+
+TEST_CASE("Philox fills are reproducible", "[random]") {
+  // Large enough to be filled in parallel
+  constexpr size_t n = 1 << 20;
+  std::vector<Scalar> a(n), b(1000);
+
+  Philox generator(42), other(42);
+  generator();  // The fills start on the next block
+  other();
+  generator.fillNormal(a.data(), n, 0, 1);
+  other.fillNormal(b.data(), b.size(), 0, 1);
+
+  // The values only depend on their position in the stream
+  for (size_t i = 0; i < b.size(); i++) CHECK(a[i] == b[i]);
+
+  double mean = 0, var = 0;
+  for (Scalar x : a) mean += x;
+  mean /= n;
+  for (Scalar x : a) var += (x - mean) * (x - mean);
+  var /= n;
+
+  REQUIRE_THAT(mean, WithinAbs(0, 0.01));
+  REQUIRE_THAT(var, WithinAbs(1, 0.01));
+
+  // The next fill continues the stream
+  std::vector<Scalar> c(4);
+  generator.fillUniform(c.data(), c.size(), 0, 1);
+  other.fillUniform(c.data(), c.size(), 0, 1);
+  CHECK(c[0] != a[0]);
+}
+
+TEST_CASE("Philox fills give the same values on the workers of a pool",
+          "[random]") {
+  constexpr size_t n = 1 << 20;
+  std::vector<Scalar> expected(n);
+  Philox(7).fillUniform(expected.data(), n, -1, 1);
+
+  // Sequential on the workers, while concurrent fills share the threads
+  WorkerPool pool(3);
+  std::vector<std::vector<Scalar>> values(pool.size(), std::vector<Scalar>(n));
+  pool.run([&](int w) { Philox(7).fillUniform(values[w].data(), n, -1, 1); });
+
+  for (const std::vector<Scalar> &v : values) CHECK(v == expected);
+  CHECK_FALSE(WorkerPool::inWorker());
+}
+
+TEST_CASE("Filling a block only writes its own values", "[random]") {
+  Matrix matrix = Matrix::Constant(6, 5, 2);
+  Philox generator(3);
+
+  // The columns of the block are 6 values apart
+  fillUniform(matrix.block(1, 1, 4, 3), generator, -1, 1);
+  fillNormal(matrix.block(1, 4, 4, 1), generator, 0, 1);
+
+  for (int r = 0; r < matrix.rows(); r++) {
+    for (int c = 0; c < matrix.cols(); c++) {
+      bool inBlock = r >= 1 && r < 5 && c >= 1;
+      if (!inBlock)
+        CHECK(matrix(r, c) == 2);
+      else if (c < 4)
+        CHECK(std::abs(matrix(r, c)) <= 1);
+      else
+        CHECK(matrix(r, c) != 2);
+    }
+  }
+}
+
+TEST_CASE("Philox draws Bernoulli values with the given probability",
+          "[random]") {
+  constexpr size_t n = 100001;  // Odd, the last word is half used
+  std::vector<uint8_t> values(n, 2);
+
+  Philox generator(3);
+  generator.fillBernoulli(values.data(), n, 0.3);
+
+  size_t ones = 0;
+  for (uint8_t v : values) {
+    REQUIRE(v <= 1);
+    ones += v;
+  }
+  REQUIRE_THAT(static_cast<double>(ones) / n, WithinAbs(0.3, 0.01));
+
+  // Never or always
+  generator.fillBernoulli(values.data(), 1000, 0);
+  CHECK(std::count(values.begin(), values.begin() + 1000, 1) == 0);
+  generator.fillBernoulli(values.data(), 1000, 1);
+  CHECK(std::count(values.begin(), values.begin() + 1000, 1) == 1000);
+}
+
+// Weights of the hidden (HE) and output (RANDOM) layers of a new network
+std::vector<Matrix> initWeights() {
+  std::vector<std::shared_ptr<Layer>> layers = {
+      std::make_shared<Dense>(16),
+      std::make_shared<Dense>(8, ACTIVATION::RELU, WEIGHT_INIT::HE),
+      std::make_shared<Dense>(2, ACTIVATION::SIGMOID, WEIGHT_INIT::RANDOM)};
+
+  Network network;
+  for (std::shared_ptr<Layer> &layer : layers) network.addLayer(layer);
+
+  return {std::static_pointer_cast<Dense>(network.getLayer(1))->getWeights(),
+          std::static_pointer_cast<Dense>(network.getLayer(2))->getWeights()};
+}
+
+TEST_CASE("setRandomSeed makes the weights initialization reproducible",
+          "[random]") {
+  setRandomSeed(7);
+  std::vector<Matrix> first = initWeights();
+  setRandomSeed(7);
+  std::vector<Matrix> second = initWeights();
+  setRandomSeed(8);
+  std::vector<Matrix> other = initWeights();
+
+  CHECK(first[0] == second[0]);
+  CHECK(first[1] == second[1]);
+  CHECK(first[0] != other[0]);
+  CHECK((first[1].array() >= -1 && first[1].array() < 1).all());
+}
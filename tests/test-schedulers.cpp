@@ -0,0 +1,185 @@
+#include <Network.hpp>
+#include <callbacks/Callback.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+using namespace NeuralNet;
+using Catch::Matchers::WithinRel;
+
+TEST_CASE("StepLR decays the rate every stepSize steps", "[schedulers]") {
+  StepLR scheduler(3, 0.5);
+
+  CHECK_FALSE(scheduler.isPerBatch());
+  CHECK(scheduler.getRate(0, 0.8) == 0.8);
+  CHECK(scheduler.getRate(2, 0.8) == 0.8);
+  CHECK(scheduler.getRate(3, 0.8) == 0.4);
+  CHECK(scheduler.getRate(7, 0.8) == 0.2);
+}
+
+TEST_CASE("CosineAnnealingLR anneals the rate down to the minimum rate",
+          "[schedulers]") {
+  CosineAnnealingLR scheduler(10, 0.01);
+
+  CHECK(scheduler.isPerBatch());
+  CHECK_THAT(scheduler.getRate(0, 0.1), WithinRel(0.1, 1e-12));
+  CHECK_THAT(scheduler.getRate(5, 0.1), WithinRel(0.055, 1e-12));
+  CHECK_THAT(scheduler.getRate(10, 0.1), WithinRel(0.01, 1e-12));
+  CHECK_THAT(scheduler.getRate(20, 0.1), WithinRel(0.01, 1e-12));
+}
+
+TEST_CASE("OneCycleLR rises to the peak rate then anneals", "[schedulers]") {
+  OneCycleLR scheduler(1, 100, 0.25, 10, 100);
+
+  CHECK_THAT(scheduler.getRate(0, 0.5), WithinRel(0.1, 1e-12));
+  CHECK_THAT(scheduler.getRate(25, 0.5), WithinRel(1, 1e-12));
+  CHECK_THAT(scheduler.getRate(100, 0.5), WithinRel(0.001, 1e-12));
+
+  // Rising during the first quarter, annealing afterwards
+  for (int step = 1; step < 25; step++)
+    CHECK(scheduler.getRate(step, 0.5) > scheduler.getRate(step - 1, 0.5));
+  for (int step = 26; step <= 100; step++)
+    CHECK(scheduler.getRate(step, 0.5) < scheduler.getRate(step - 1, 0.5));
+}
+
+TEST_CASE("WarmupLR warms up linearly then hands over", "[schedulers]") {
+  std::shared_ptr<LRScheduler> cosine =
+      std::make_shared<CosineAnnealingLR>(10);
+  WarmupLR scheduler(4, cosine);
+
+  CHECK_THAT(scheduler.getRate(0, 0.2), WithinRel(0.05, 1e-12));
+  CHECK_THAT(scheduler.getRate(3, 0.2), WithinRel(0.2, 1e-12));
+  // The cosine annealing starts at the end of the warmup
+  CHECK_THAT(scheduler.getRate(4, 0.2), WithinRel(0.2, 1e-12));
+  CHECK_THAT(scheduler.getRate(9, 0.2), WithinRel(0.1, 1e-12));
+  CHECK(scheduler.getRate(14, 0.2) == 0);
+
+  WarmupLR constant(2);
+  CHECK(constant.getRate(5, 0.2) == 0.2);
+}
+
+TEST_CASE("ReduceLROnPlateau reduces the rate once the loss stops improving",
+          "[schedulers]") {
+  ReduceLROnPlateau scheduler(0.5, 2, 0.01);
+
+  CHECK_FALSE(scheduler.isPerBatch());
+
+  // Improving, then within minDelta of the best loss for 3 epochs
+  for (double loss : {1.0, 0.9, 0.895, 0.9, 0.899}) {
+    CHECK(scheduler.getRate(0, 0.1) == 0.1);
+    scheduler.onEpochEnd(loss);
+  }
+  CHECK(scheduler.getRate(0, 0.1) == 0.05);
+
+  scheduler.reset();
+  CHECK(scheduler.getRate(0, 0.1) == 0.1);
+
+  ReduceLROnPlateau bounded(0.1, 0, 0, 0.02);
+  bounded.onEpochEnd(1);
+  bounded.onEpochEnd(1);
+  bounded.onEpochEnd(1);
+  CHECK(bounded.getRate(0, 0.1) == 0.02);
+}
+
+TEST_CASE("The schedulers reject invalid arguments", "[schedulers]") {
+  CHECK_THROWS_AS(StepLR(0), std::invalid_argument);
+  CHECK_THROWS_AS(CosineAnnealingLR(0), std::invalid_argument);
+  CHECK_THROWS_AS(OneCycleLR(1, 1), std::invalid_argument);
+  CHECK_THROWS_AS(OneCycleLR(1, 10, 1), std::invalid_argument);
+  CHECK_THROWS_AS(WarmupLR(0), std::invalid_argument);
+  CHECK_THROWS_AS(ReduceLROnPlateau(1), std::invalid_argument);
+}
+
+/**
+ * Records the learning rate of the optimizer at every epoch and batch
+ */
+class RateRecorder : public Callback {
+ public:
+  explicit RateRecorder(std::shared_ptr<Optimizer> optimizer)
+      : optimizer(optimizer){};
+
+  std::vector<double> epochRates, batchRates;
+
+  void onTrainBegin(Model &model) override {}
+  void onTrainEnd(Model &model) override {}
+  void onEpochBegin(Model &model) override {
+    epochRates.push_back(optimizer->getAlpha());
+  }
+  void onEpochEnd(Model &model) override {}
+  void onBatchBegin(Model &model) override {
+    batchRates.push_back(optimizer->getAlpha());
+  }
+  void onBatchEnd(Model &model) override {}
+
+ private:
+  std::shared_ptr<Optimizer> optimizer;
+};
+
+/**
+ * Trains a small network with the schedule on 4 batches per epoch and
+ * returns the recorded rates
+ */
+std::shared_ptr<RateRecorder> trainWith(std::shared_ptr<LRScheduler> scheduler,
+                                        std::shared_ptr<Optimizer> optimizer,
+                                        int epochs) {
+  Network network;
+  network.setup(optimizer, LOSS::QUADRATIC);
+  network.setScheduler(scheduler);
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(2);
+  std::shared_ptr<Layer> outputLayer = std::make_shared<Dense>(2);
+  network.addLayer(inputLayer);
+  network.addLayer(outputLayer);
+
+  std::vector<std::vector<double>> inputs;
+  std::vector<double> labels;
+  for (int i = 0; i < 8; i++) {
+    inputs.push_back({i * 0.1, (i % 3) * 0.2});
+    labels.push_back(i % 2);
+  }
+
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(inputs, labels);
+  trainingData.batch(2, false, true, false, false, true, 7);
+
+  std::shared_ptr<RateRecorder> recorder =
+      std::make_shared<RateRecorder>(optimizer);
+  std::vector<std::shared_ptr<Callback>> callbacks = {recorder};
+  network.train(trainingData, epochs, callbacks, false);
+
+  // The optimizer gets its rate back after the training
+  CHECK(optimizer->getAlpha() == 0.1);
+  return recorder;
+}
+
+TEST_CASE("The training applies the schedule to the optimizer",
+          "[schedulers]") {
+  std::shared_ptr<Optimizer> optimizer = std::make_shared<SGD>(0.1);
+
+  SECTION("Per epoch") {
+    std::shared_ptr<RateRecorder> recorder =
+        trainWith(std::make_shared<StepLR>(1, 0.5), optimizer, 3);
+
+    REQUIRE(recorder->epochRates.size() == 3);
+    CHECK(recorder->epochRates[0] == 0.1);
+    CHECK(recorder->epochRates[1] == 0.05);
+    CHECK(recorder->epochRates[2] == 0.025);
+    CHECK(recorder->batchRates[7] == 0.05);
+  }
+
+  SECTION("Per batch, starting over at every training") {
+    std::shared_ptr<LRScheduler> scheduler = std::make_shared<WarmupLR>(4);
+
+    for (int training = 0; training < 2; training++) {
+      std::shared_ptr<RateRecorder> recorder =
+          trainWith(scheduler, optimizer, 2);
+
+      REQUIRE(recorder->batchRates.size() == 8);
+      CHECK_THAT(recorder->batchRates[0], WithinRel(0.025, 1e-12));
+      CHECK_THAT(recorder->batchRates[2], WithinRel(0.075, 1e-12));
+      CHECK(recorder->batchRates[7] == 0.1);
+    }
+  }
+}
@@ -0,0 +1,204 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <Network.hpp>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <serving/InferenceServer.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test-macros.hpp"
+
+using namespace NeuralNet;
+
+std::shared_ptr<Network> servedNetwork() {
+  std::shared_ptr<Network> network = std::make_shared<Network>();
+  network->setup(std::make_shared<SGD>(1), LOSS::MCE);
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(6);
+  std::shared_ptr<Layer> hiddenLayer =
+      std::make_shared<Dense>(16, ACTIVATION::RELU, WEIGHT_INIT::HE);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(3, ACTIVATION::SOFTMAX, WEIGHT_INIT::LECUN);
+
+  network->addLayer(inputLayer);
+  network->addLayer(hiddenLayer);
+  network->addLayer(outputLayer);
+
+  return network;
+}
+
+TEST_CASE("Inference server batches concurrent requests over a Unix socket",
+          "[server]") {
+  std::shared_ptr<Network> network = servedNetwork();
+  const std::string path =
+      "/tmp/neuralnet-test-" + std::to_string(::getpid()) + ".sock";
+
+  // Waiting long enough for the concurrent requests to end up batched
+  InferenceServer server(*network, 8, std::chrono::milliseconds(20));
+  server.listenUnix(path);
+  server.start();
+
+  const int nClients = 8, nRequests = 10;
+  std::atomic<int> nMismatches{0};
+  std::vector<std::thread> clients;
+
+  for (int t = 0; t < nClients; t++) {
+    clients.emplace_back([&, t] {
+      InferenceClient client;
+      client.connectUnix(path);
+      InferenceSession session(*network);
+
+      for (int i = 0; i < nRequests; i++) {
+        Matrix x = Matrix::Constant(1 + (i + t) % 2, 6, 0.1 * (t - i));
+        // The samples go through the wire as float32
+        x = x.cast<float>().cast<Scalar>();
+
+        const Matrix outputs = client.predict(x);
+        const Matrix expected = session.predict(x);
+        if (!outputs.isApprox(expected, 1e-5)) nMismatches++;
+      }
+    });
+  }
+
+  for (std::thread &client : clients) client.join();
+  server.stop();
+
+  CHECK(nMismatches == 0);
+
+  const InferenceServer::Stats stats = server.getStats();
+  CHECK(stats.nRequests == nClients * nRequests);
+  CHECK(stats.nSamples == nClients * nRequests * 3 / 2);
+  CHECK(stats.nBatches < stats.nRequests);
+  CHECK(stats.p50 > 0);
+  CHECK(stats.p50 <= stats.p99);
+  CHECK(stats.requestsPerSecond > 0);
+}
+
+TEST_CASE("Inference server answers over localhost TCP", "[server]") {
+  std::shared_ptr<Network> network = servedNetwork();
+
+  InferenceServer server(*network, 32, std::chrono::microseconds(100));
+  server.listenTcp(0);
+  server.start();
+  REQUIRE(server.getPort() > 0);
+
+  InferenceClient client;
+  client.connectTcp(server.getPort());
+  InferenceSession session(*network);
+
+  // A request larger than the maximum batch size is served on its own
+  Matrix x = Matrix::Random(40, 6).cast<float>().cast<Scalar>();
+  CHECK(client.predict(x).isApprox(session.predict(x), 1e-5));
+
+  // Wrong number of features, the server closes the connection
+  CHECK_THROWS_AS(client.predict(Matrix::Zero(2, 5)), std::runtime_error);
+  CHECK_THROWS_AS(client.predict(x.topRows(3)), std::runtime_error);
+
+  // The server still serves the other connections
+  InferenceClient other;
+  other.connectTcp(server.getPort());
+  CHECK(other.predict(x.topRows(3))
+            .isApprox(session.predict(x.topRows(3)), 1e-5));
+
+  server.stop();
+  CHECK(server.getStats().nBatches == 2);
+}
+
+TEST_CASE("Inference server rejects oversized requests before reading them",
+          "[server]") {
+  std::shared_ptr<Network> network = servedNetwork();
+
+  InferenceServer server(*network);
+  server.listenTcp(0);
+  server.start();
+
+  // A header announcing 2^64 bytes of samples, without any sample
+  {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(server.getPort()));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                      sizeof(address)) == 0);
+
+    wire::RequestHeader header;
+    header.rows = header.cols = 0xFFFFFFFF;
+    REQUIRE(wire::writeAll(fd, &header, sizeof(header)));
+
+    wire::ResponseHeader response;
+    REQUIRE(wire::readAll(fd, &response, sizeof(response)));
+    CHECK(response.status == 1);
+
+    // Closed by the server
+    char byte;
+    CHECK(::read(fd, &byte, 1) == 0);
+    ::close(fd);
+  }
+
+  // Many short connections, their threads are joined as they close
+  for (int i = 0; i < 20; i++) {
+    InferenceClient client;
+    client.connectTcp(server.getPort());
+    CHECK(client.predict(Matrix::Zero(1, 6)).cols() == 3);
+  }
+
+  server.stop();
+}
+
+TEST_CASE("Inference server only replaces a stale socket", "[server]") {
+  std::shared_ptr<Network> network = servedNetwork();
+  const std::string path =
+      "/tmp/neuralnet-test-stale-" + std::to_string(::getpid()) + ".sock";
+
+  // A regular file at the path is left untouched
+  { std::ofstream(path) << "data"; }
+  {
+    InferenceServer server(*network);
+    CHECK_THROWS_AS(server.listenUnix(path), std::runtime_error);
+  }
+  struct stat status;
+  REQUIRE(::lstat(path.c_str(), &status) == 0);
+  CHECK(S_ISREG(status.st_mode));
+  ::unlink(path.c_str());
+
+  // A server that never started still closes its listener and its socket
+  {
+    InferenceServer server(*network);
+    server.listenUnix(path);
+  }
+  CHECK(::lstat(path.c_str(), &status) != 0);
+
+  // A stale socket (its server is gone) is replaced
+  {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(::bind(fd, reinterpret_cast<sockaddr *>(&address),
+                   sizeof(address)) == 0);
+    ::close(fd);
+  }
+  {
+    InferenceServer server(*network);
+    server.listenUnix(path);
+    server.start();
+
+    InferenceClient client;
+    client.connectUnix(path);
+    CHECK(client.predict(Matrix::Zero(1, 6)).cols() == 3);
+  }
+  CHECK(::lstat(path.c_str(), &status) != 0);
+}
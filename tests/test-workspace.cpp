@@ -0,0 +1,127 @@
+#include <Network.hpp>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace NeuralNet;
+
+#ifndef EIGEN_RUNTIME_NO_MALLOC
+#error "The test must be built with EIGEN_RUNTIME_NO_MALLOC"
+#endif
+
+#ifdef NDEBUG
+#error "The test must be built with Eigen's asserts (without NDEBUG)"
+#endif
+
+// Counting the allocations that go through operator new (Eigen allocates
+// with malloc, its allocations are caught by set_is_malloc_allowed)
+static std::atomic<size_t> nAllocations{0};
+
+void *operator new(std::size_t size) {
+  nAllocations++;
+  if (void *ptr = std::malloc(size ? size : 1)) return ptr;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+/**
+ * Records the number of allocations made during each training step. Eigen
+ * asserts on any matrix allocation after the first step, which sizes the
+ * buffers.
+ */
+class AllocationCounter : public Callback {
+ public:
+  std::vector<size_t> stepAllocations;
+
+  AllocationCounter() { stepAllocations.reserve(100); }
+
+  void onTrainBegin(Model &model) override {};
+  void onTrainEnd(Model &model) override {};
+  void onEpochBegin(Model &model) override {};
+  void onEpochEnd(Model &model) override {};
+
+  void onBatchBegin(Model &model) override {
+    start = nAllocations;
+    if (!stepAllocations.empty())
+      Eigen::internal::set_is_malloc_allowed(false);
+  };
+
+  void onBatchEnd(Model &model) override {
+    Eigen::internal::set_is_malloc_allowed(true);
+    stepAllocations.push_back(nAllocations - start);
+  };
+
+ private:
+  size_t start = 0;
+};
+
+/**
+ * Trains a small network (with a dropout layer) and returns the number of
+ * allocations made during each training step
+ */
+std::vector<size_t> countStepAllocations(std::shared_ptr<Optimizer> optimizer,
+                                         LOSS loss) {
+  Network network;
+
+  std::shared_ptr<Layer> inputLayer = std::make_shared<Dense>(4);
+  std::shared_ptr<Layer> hiddenLayer =
+      std::make_shared<Dense>(8, ACTIVATION::RELU, WEIGHT_INIT::HE);
+  std::shared_ptr<Layer> dropoutLayer = std::make_shared<Dropout>(0.25, 42);
+  std::shared_ptr<Layer> outputLayer =
+      std::make_shared<Dense>(3, ACTIVATION::SOFTMAX, WEIGHT_INIT::GLOROT);
+
+  network.addLayer(inputLayer);
+  network.addLayer(hiddenLayer);
+  network.addLayer(dropoutLayer);
+  network.addLayer(outputLayer);
+  network.setup(optimizer, loss);
+
+  std::vector<std::vector<double>> inputs;
+  std::vector<double> labels;
+
+  for (int i = 0; i < 32; i++) {
+    inputs.push_back({i * 0.1, -i * 0.2, (i % 5) * 0.3, 1});
+    labels.push_back(i % 3);
+  }
+
+  TrainingData<std::vector<std::vector<double>>, std::vector<double>>
+      trainingData(inputs, labels);
+  trainingData.batch(8);
+
+  std::shared_ptr<AllocationCounter> counter =
+      std::make_shared<AllocationCounter>();
+
+  network.train(trainingData, 3, {counter}, false);
+
+  return counter->stepAllocations;
+}
+
+TEST_CASE("Steady-state training steps don't allocate memory with SGD",
+          "[workspace]") {
+  std::vector<size_t> stepAllocations =
+      countStepAllocations(std::make_shared<SGD>(0.1), LOSS::QUADRATIC);
+
+  REQUIRE(stepAllocations.size() == 12);
+
+  // Only the first step sizes the buffers
+  for (size_t s = 1; s < stepAllocations.size(); s++) {
+    CHECK(stepAllocations[s] == 0);
+  }
+}
+
+TEST_CASE("Steady-state training steps don't allocate memory with Adam",
+          "[workspace]") {
+  std::vector<size_t> stepAllocations =
+      countStepAllocations(std::make_shared<Adam>(0.01), LOSS::MCE);
+
+  REQUIRE(stepAllocations.size() == 12);
+
+  for (size_t s = 1; s < stepAllocations.size(); s++) {
+    CHECK(stepAllocations[s] == 0);
+  }
+}